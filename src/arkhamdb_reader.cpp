@@ -0,0 +1,254 @@
+#include "arkhamdb_reader.h"
+
+#include "nlohmann/json.hpp"
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+namespace
+{
+using json = nlohmann::json;
+
+class ArkhamDBSaxHandler: public nlohmann::json_sax<json>
+{
+public:
+  explicit ArkhamDBSaxHandler(std::vector<ArkhamDBCardData>& cards): mCards{cards} {}
+
+  bool null() override
+  {
+    mField = Field::kIgnored;
+    return true;
+  }
+
+  bool boolean(bool) override
+  {
+    mField = Field::kIgnored;
+    return true;
+  }
+
+  bool number_integer(number_integer_t value) override
+  {
+    SetNumber(value);
+    return true;
+  }
+
+  bool number_unsigned(number_unsigned_t value) override
+  {
+    SetNumber(static_cast<int64_t>(std::min<number_unsigned_t>(value, std::numeric_limits<int64_t>::max())));
+    return true;
+  }
+
+  bool number_float(number_float_t value, const string_t&) override
+  {
+    SetNumber(static_cast<int64_t>(value));
+    return true;
+  }
+
+  bool string(string_t& value) override
+  {
+    if (IsCardField())
+    {
+      if (auto* field = GetStringField())
+        *field = std::move(value);
+    }
+    mField = Field::kIgnored;
+    return true;
+  }
+
+  bool binary(binary_t&) override
+  {
+    return true;
+  }
+
+  bool start_object(std::size_t) override
+  {
+    if (++mDepth == kCardDepth)
+      mCard = ArkhamDBCardData{};
+    mField = Field::kIgnored;
+    return true;
+  }
+
+  bool key(string_t& value) override
+  {
+    mField = mDepth == kCardDepth ? GetField(value) : Field::kIgnored;
+    return true;
+  }
+
+  bool end_object() override
+  {
+    if (mDepth-- == kCardDepth)
+      mCards.push_back(std::move(mCard));
+    mField = Field::kIgnored;
+    return true;
+  }
+
+  bool start_array(std::size_t) override
+  {
+    ++mDepth;
+    mField = Field::kIgnored;
+    return true;
+  }
+
+  bool end_array() override
+  {
+    --mDepth;
+    mField = Field::kIgnored;
+    return true;
+  }
+
+  bool parse_error(std::size_t position, const std::string&, const nlohmann::detail::exception& e) override
+  {
+    throw std::runtime_error(fmt::format("Invalid arkhamdb file at byte {}: {}", position, e.what()));
+  }
+
+private:
+  // The file is an array of cards: depth 1 is the array, depth 2 the fields of a card. Deeper values (deck
+  // requirements, restrictions...) are skipped.
+  static inline constexpr int kCardDepth = 2;
+
+  enum class Field
+  {
+    kCode,
+    kName,
+    kSubname,
+    kTypeCode,
+    kSubtypeCode,
+    kFactionCode,
+    kPackCode,
+    kTraits,
+    kSlot,
+    kText,
+    kCost,
+    kXp,
+    kQuantity,
+    kSkillWillpower,
+    kSkillIntellect,
+    kSkillCombat,
+    kSkillAgility,
+    kSkillWild,
+    kHealth,
+    kSanity,
+    kEnemyFight,
+    kEnemyEvade,
+    kEnemyDamage,
+    kEnemyHorror,
+    kShroud,
+    kClues,
+    kDoom,
+    kVictory,
+    kIgnored
+  };
+
+  static Field GetField(const std::string_view key)
+  {
+    static const std::unordered_map<std::string_view, Field> kFields = {
+      {"code", Field::kCode},
+      {"name", Field::kName},
+      {"subname", Field::kSubname},
+      {"type_code", Field::kTypeCode},
+      {"subtype_code", Field::kSubtypeCode},
+      {"faction_code", Field::kFactionCode},
+      {"pack_code", Field::kPackCode},
+      {"traits", Field::kTraits},
+      {"slot", Field::kSlot},
+      {"text", Field::kText},
+      {"cost", Field::kCost},
+      {"xp", Field::kXp},
+      {"quantity", Field::kQuantity},
+      {"skill_willpower", Field::kSkillWillpower},
+      {"skill_intellect", Field::kSkillIntellect},
+      {"skill_combat", Field::kSkillCombat},
+      {"skill_agility", Field::kSkillAgility},
+      {"skill_wild", Field::kSkillWild},
+      {"health", Field::kHealth},
+      {"sanity", Field::kSanity},
+      {"enemy_fight", Field::kEnemyFight},
+      {"enemy_evade", Field::kEnemyEvade},
+      {"enemy_damage", Field::kEnemyDamage},
+      {"enemy_horror", Field::kEnemyHorror},
+      {"shroud", Field::kShroud},
+      {"clues", Field::kClues},
+      {"doom", Field::kDoom},
+      {"victory", Field::kVictory}};
+    const auto it = kFields.find(key);
+    return it == kFields.end() ? Field::kIgnored : it->second;
+  }
+
+  bool IsCardField() const
+  {
+    return mDepth == kCardDepth && mField != Field::kIgnored;
+  }
+
+  std::string* GetStringField()
+  {
+    switch (mField)
+    {
+      case Field::kCode: return &mCard.code;
+      case Field::kName: return &mCard.name;
+      case Field::kSubname: return &mCard.subname;
+      case Field::kTypeCode: return &mCard.type_code;
+      case Field::kSubtypeCode: return &mCard.subtype_code;
+      case Field::kFactionCode: return &mCard.faction_code;
+      case Field::kPackCode: return &mCard.pack_code;
+      case Field::kTraits: return &mCard.traits;
+      case Field::kSlot: return &mCard.slot;
+      case Field::kText: return &mCard.text;
+      default: return nullptr;
+    }
+  }
+
+  void SetNumber(const int64_t value)
+  {
+    if (!IsCardField())
+      return;
+
+    const auto small = static_cast<int8_t>(std::clamp<int64_t>(value, INT8_MIN, INT8_MAX));
+    const auto count = static_cast<uint8_t>(std::clamp<int64_t>(value, 0, UINT8_MAX));
+    switch (mField)
+    {
+      case Field::kCost: mCard.cost = small; break;
+      case Field::kXp: mCard.xp = count; break;
+      case Field::kQuantity: mCard.quantity = count; break;
+      case Field::kSkillWillpower: mCard.skill.willpower = small; break;
+      case Field::kSkillIntellect: mCard.skill.intellect = small; break;
+      case Field::kSkillCombat: mCard.skill.combat = small; break;
+      case Field::kSkillAgility: mCard.skill.agility = small; break;
+      case Field::kSkillWild: mCard.skill.wild = small; break;
+      case Field::kHealth: mCard.health = count; break;
+      case Field::kSanity: mCard.sanity = count; break;
+      case Field::kEnemyFight: mCard.enemy_fight = count; break;
+      case Field::kEnemyEvade: mCard.enemy_evade = count; break;
+      case Field::kEnemyDamage: mCard.enemy_damage = count; break;
+      case Field::kEnemyHorror: mCard.enemy_horror = count; break;
+      case Field::kShroud: mCard.shroud = count; break;
+      case Field::kClues: mCard.clues = count; break;
+      case Field::kDoom: mCard.doom = count; break;
+      case Field::kVictory: mCard.victory = count; break;
+      default: break;
+    }
+    mField = Field::kIgnored;
+  }
+
+  std::vector<ArkhamDBCardData>& mCards;
+  ArkhamDBCardData mCard;
+  Field mField{Field::kIgnored};
+  int mDepth{0};
+};
+} // namespace
+
+size_t ArkhamDBReader::Read(const std::string& path, std::vector<ArkhamDBCardData>& cards)
+{
+  std::ifstream file{path, std::ios::binary};
+  if (!file.is_open())
+    throw std::runtime_error(fmt::format("Can not open arkhamdb file '{}'", path));
+
+  const size_t previousSize = cards.size();
+  ArkhamDBSaxHandler handler{cards};
+  json::sax_parse(file, &handler);
+  return cards.size() - previousSize;
+}
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "card_db_data.h"
+
+#include <string>
+#include <vector>
+
+// Streams an arkhamdb card dump (a json array of cards) through the nlohmann SAX interface. Only the card being
+// read is kept in memory besides the output, no json document is built.
+class ArkhamDBReader
+{
+public:
+  // Appends the cards of the file to cards, returns how many were read
+  static size_t Read(const std::string& path, std::vector<ArkhamDBCardData>& cards);
+};
@@ -1,11 +1,12 @@
 #pragma once
 
 #include "card.h"
+#include "card_id.h"
 
 class Asset: public Card
 {
 public:
-  Asset(const std::string& name,
+  Asset(const std::string_view name,
         const Faction faction,
         const Skill& skill,
         const uint8_t cost,
@@ -22,6 +23,31 @@ public:
   {}
   friend bool operator==(const Asset& rhs, const Asset& lhs);
 
+  uint8_t GetCost() const
+  {
+    return mCost;
+  }
+
+  Slot GetSlot() const
+  {
+    return mSlot;
+  }
+
+  std::optional<uint8_t> GetUses() const
+  {
+    return mUses;
+  }
+
+  std::optional<uint8_t> GetHealth() const
+  {
+    return mHealth;
+  }
+
+  std::optional<uint8_t> GetSanity() const
+  {
+    return mSanity;
+  }
+
 private:
   uint8_t mCost;                // Recursos para jugarla
   Slot mSlot;                   // Espacio que ocupa
@@ -32,17 +58,34 @@ private:
   friend struct fmt::formatter<Asset>;
 };
 
+// Mutable state of one copy of an asset in a game. The Asset itself is the immutable prototype shared by all of
+// them
+struct AssetState
+{
+  AssetState() = default;
+  AssetState(const CardId pCard, const Asset& asset): card{pCard}, usesLeft{asset.GetUses().value_or(0)} {}
+
+  // Soak assets are defeated once they have as much damage (horror) as their health (sanity)
+  bool IsDefeated(const Asset& asset) const
+  {
+    return (asset.GetHealth().has_value() && damage >= asset.GetHealth().value())
+           || (asset.GetSanity().has_value() && horror >= asset.GetSanity().value());
+  }
+
+  CardId card{kInvalidCardId};
+  uint8_t usesLeft{0};
+  uint8_t damage{0};
+  uint8_t horror{0};
+  bool exhausted{false};
+};
+
 static inline bool operator==(const Asset& rhs, const Asset& lhs)
 {
   return std::tie(rhs.mName, rhs.mFaction, rhs.mTestSkill, rhs.mCost, rhs.mSlot)
            == std::tie(lhs.mName, lhs.mFaction, lhs.mTestSkill, lhs.mCost, lhs.mSlot)
          && lhs.mUses.value_or(0) == rhs.mUses.value_or(0) && lhs.mSanity.value_or(0) == rhs.mSanity.value_or(0)
          && lhs.mHealth.value_or(0) == rhs.mHealth.value_or(0)
-         && CompareVectorOfSharedPtr(lhs.mEffects.at(EffectType::kActivate),
-                                     rhs.mEffects.at(EffectType::kActivate))
-         && CompareVectorOfSharedPtr(lhs.mEffects.at(EffectType::kTrigger), rhs.mEffects.at(EffectType::kTrigger))
-         && CompareVectorOfSharedPtr(lhs.mEffects.at(EffectType::kDiscard), rhs.mEffects.at(EffectType::kDiscard))
-         && CompareVectorOfSharedPtr(lhs.mEffects.at(EffectType::kPasive), rhs.mEffects.at(EffectType::kPasive));
+         && lhs.mEffects == rhs.mEffects;
 }
 
 template<>
@@ -1,11 +1,12 @@
 #pragma once
 #include "effect.h"
 #include "faction.h"
-#include "helpers.h"
 #include "skill.h"
 #include "slot.h"
 #include "spdlog/spdlog.h"
+#include "string_interner.h"
 #include "string_to_enum.h"
+#include "trait.h"
 
 #include <algorithm>
 #include <array>
@@ -14,21 +15,41 @@
 #include <memory>
 #include <optional>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 
 class Card
 {
 public:
-  Card(const std::string& name, const Faction faction, const Skill& skill):
-    mName{name},
+  Card(const std::string_view name, const Faction faction, const Skill& skill):
+    mName{StringInterner::Instance().Intern(name)},
     mFaction{faction},
     mTestSkill{skill}
+  {}
+
+  std::string_view GetName() const
+  {
+    return StringInterner::Instance().Get(mName);
+  }
+
+  NameHandle GetNameHandle() const
+  {
+    return mName;
+  }
+
+  void SetTraits(const TraitMask& traits)
+  {
+    mTraits = traits;
+  }
+
+  const TraitMask& GetTraits() const
+  {
+    return mTraits;
+  }
+
+  bool HasTrait(const TraitId trait) const
   {
-    mEffects.insert({EffectType::kActivate, {}});
-    mEffects.insert({EffectType::kTrigger, {}});
-    mEffects.insert({EffectType::kPasive, {}});
-    mEffects.insert({EffectType::kDiscard, {}});
+    return mTraits.Has(trait);
   }
 
   virtual const Skill& GetSkill() const
@@ -36,43 +57,48 @@ public:
     return mTestSkill;
   }
 
-  void RegisterActivationEffect(const std::shared_ptr<Effect>& effect)
+  void RegisterActivationEffect(EffectVariant effect)
   {
     mEffects[EffectType::kActivate].push_back(std::move(effect));
   }
 
-  void RegisterTriggerEffect(const std::shared_ptr<Effect>& effect)
+  void RegisterTriggerEffect(EffectVariant effect)
   {
     mEffects[EffectType::kTrigger].push_back(std::move(effect));
   }
 
-  void RegisterDiscardEffect(const std::shared_ptr<Effect>& effect)
+  void RegisterDiscardEffect(EffectVariant effect)
   {
     mEffects[EffectType::kDiscard].push_back(std::move(effect));
   }
 
-  void RegisterPasiveEffect(const std::shared_ptr<Effect>& effect)
+  void RegisterPasiveEffect(EffectVariant effect)
   {
     mEffects[EffectType::kPasive].push_back(std::move(effect));
   }
 
-  const std::vector<std::shared_ptr<Effect>>& GetActivationEffect() const
+  const EffectList& GetActivationEffect() const
   {
     return mEffects.at(EffectType::kActivate);
   }
 
-  const std::vector<std::shared_ptr<Effect>>& GetTriggerEffect() const
+  const EffectList& GetTriggerEffect() const
   {
     return mEffects.at(EffectType::kTrigger);
   }
 
+  const EffectList& GetPasiveEffect() const
+  {
+    return mEffects.at(EffectType::kPasive);
+  }
+
 protected:
-  std::string mName;
-  std::string mTraits;
+  NameHandle mName;
+  TraitMask mTraits;
   Faction mFaction;
   Skill mTestSkill;
 
-  std::unordered_map<EffectType, std::vector<std::shared_ptr<Effect>>> mEffects;
+  EffectTable<EffectList> mEffects;
 
 private:
   friend struct fmt::formatter<Card>;
@@ -84,26 +110,26 @@ struct fmt::formatter<Card>: fmt::formatter<std::string>
   {
     auto it = fmt::format_to(ctx.out(),
                              "'name': {}, 'traits': {}, 'faction': {}, 'test_skill': {}",
-                             card.mName,
+                             card.GetName(),
                              card.mTraits,
                              StringToEnum::GetString<Faction>(card.mFaction),
                              card.mTestSkill);
     it = fmt::format_to(it, "{{'activationEffects':[");
     std::for_each(card.mEffects.at(EffectType::kActivate).begin(),
                   card.mEffects.at(EffectType::kActivate).end(),
-                  [&it](const auto& effect) { it = fmt::format_to(it, "{{{}}}, ", *effect); });
+                  [&it](const auto& effect) { it = fmt::format_to(it, "{{{}}}, ", effect); });
     it = fmt::format_to(it, "]}}, {{'triggerEffects':[");
     std::for_each(card.mEffects.at(EffectType::kTrigger).begin(),
                   card.mEffects.at(EffectType::kTrigger).end(),
-                  [&it](const auto& effect) { it = fmt::format_to(it, "{{{}}}, ", *effect); });
+                  [&it](const auto& effect) { it = fmt::format_to(it, "{{{}}}, ", effect); });
     it = fmt::format_to(it, "]}}, {{'passiveEffects':[");
     std::for_each(card.mEffects.at(EffectType::kPasive).begin(),
                   card.mEffects.at(EffectType::kPasive).end(),
-                  [&it](const auto& effect) { it = fmt::format_to(it, "{{{}}}, ", *effect); });
+                  [&it](const auto& effect) { it = fmt::format_to(it, "{{{}}}, ", effect); });
     it = fmt::format_to(it, "]}}, {{'discardEffects':[");
     std::for_each(card.mEffects.at(EffectType::kDiscard).begin(),
                   card.mEffects.at(EffectType::kDiscard).end(),
-                  [&it](const auto& effect) { it = fmt::format_to(it, "{{{}}}, ", *effect); });
+                  [&it](const auto& effect) { it = fmt::format_to(it, "{{{}}}, ", effect); });
     it = fmt::format_to(it, "]}}");
     return it;
   }
@@ -0,0 +1,40 @@
+#include "card_db_reader.h"
+#include "card_image.h"
+#include "embedded_cards.h"
+#include "spdlog/spdlog.h"
+
+#include <exception>
+#include <string_view>
+
+// Compiles the json card data into the binary image loaded by CardDB, or with --cpp into the header of constexpr
+// tables built into ArkhamHorror_Lib when ARKHAM_EMBEDDED_CARDS is on
+int main(int argc, char** argv)
+{
+  const bool cpp = argc == 4 && std::string_view{argv[1]} == "--cpp";
+  if (argc != 3 && !cpp)
+  {
+    spdlog::error("Usage: {} [--cpp] <cards.json> <cards.bin | embedded_card_data.h>", argv[0]);
+    return 1;
+  }
+
+  const char* input = argv[argc - 2];
+  const char* output = argv[argc - 1];
+  try
+  {
+    const auto tables = CardDBReader::ReadJson(input);
+    if (cpp)
+      EmbeddedCards::WriteHeaderFile(tables, output);
+    else
+      CardImage::WriteFile(tables, output);
+    spdlog::info("{} investigators and {} assets written to {}",
+                 tables.investigators.size(),
+                 tables.assets.size(),
+                 output);
+  }
+  catch (const std::exception& e)
+  {
+    spdlog::error("{}", e.what());
+    return 1;
+  }
+  return 0;
+}
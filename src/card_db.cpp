@@ -1,169 +1,204 @@
 #include "card_db.h"
 
-#include "nlohmann/json.hpp"
+#include "arkhamdb_reader.h"
+#include "card_db_reader.h"
+#include "card_image.h"
+#include "embedded_cards.h"
 #include "spdlog/spdlog.h"
 
-Skill ReadSkillObject(const nlohmann::json& object)
+#include <algorithm>
+#include <filesystem>
+
+#ifdef ARKHAM_EMBEDDED_CARDS
+#include "embedded_card_data.h"
+#endif
+
+std::shared_ptr<const CardDB::Source> CardDB::Source::Open()
 {
-  Skill skill;
-  if (auto it = object.find("combat"); it != object.end())
-  {
-    skill.combat = it.value();
-  }
-  if (auto it = object.find("agility"); it != object.end())
-  {
-    skill.agility = it.value();
-  }
-  if (auto it = object.find("willpower"); it != object.end())
+#ifdef ARKHAM_EMBEDDED_CARDS
+  return std::make_shared<Source>();
+#else
+  // The compiled image is mapped, its pages are only read with the section that needs them. The json file is only
+  // scanned for the bounds of its sections when there is no image
+  return Open(std::filesystem::exists(kCardImagePath) ? kCardImagePath : kCardFilePath);
+#endif
+}
+
+std::shared_ptr<const CardDB::Source> CardDB::Source::Open(const std::string& path)
+{
+  auto source = std::make_shared<Source>();
+  if (std::filesystem::path{path}.extension() == ".json")
+    source->mJsonIndex = CardDBReader::IndexJson(path);
+  else
+    source->mImage = std::make_unique<MappedFile>(path);
+  return source;
+}
+
+void CardDB::Source::ReadSection(const CardSection section, CardDBTables& tables) const
+{
+  if (mImage)
+    CardImage::Read({mImage->Data(), mImage->Size()}, section, tables);
+  else if (mJsonIndex)
+    CardDBReader::ReadSection(*mJsonIndex, section, tables);
+#ifdef ARKHAM_EMBEDDED_CARDS
+  // Built into the binary with the effects already compiled, there is nothing to open, parse or compile
+  else
   {
-    skill.willpower = it.value();
+    EmbeddedCards::Read(EmbeddedCardData::kTables, section, tables);
+    return;
   }
-  if (auto it = object.find("intellect"); it != object.end())
+#endif
+  if (section == CardSection::kAssets)
   {
-    skill.intellect = it.value();
+    for (auto& [_, asset]: tables.assets)
+      CompileEffects(asset);
   }
-  if (auto it = object.find("wild"); it != object.end())
+}
+
+std::vector<std::string> CardDB::GetDefaultArkhamDBFiles()
+{
+#ifdef ARKHAM_EMBEDDED_CARDS
+  // Embedded builds never open a file on their own, the pool starts empty until LoadArkhamDB is called
+  return {};
+#else
+  if (std::filesystem::exists(kArkhamDBFilePath))
+    return {kArkhamDBFilePath};
+  return {};
+#endif
+}
+
+CardDB::ArkhamDBPool CardDB::ReadArkhamDB(const std::vector<std::string>& files)
+{
+  ArkhamDBPool pool;
+  for (const auto& file: files)
   {
-    skill.wild = it.value();
+    std::vector<ArkhamDBCardData> cards;
+    ArkhamDBReader::Read(file, cards);
+    MergeArkhamDB(pool, std::move(cards));
   }
-  return skill;
+  return pool;
 }
 
-void ReadInvestigatorsObject(const nlohmann::json& object,
-                             std::unordered_map<std::string, CardDB::InvestigatorCardDBData>& investigators)
+void CardDB::MergeArkhamDB(ArkhamDBPool& pool, std::vector<ArkhamDBCardData> cards)
 {
-  for (const auto& element: object)
+  for (auto& card: cards)
   {
-    CardDB::InvestigatorCardDBData investigator;
-    investigator.name = element.at("name");
-    investigator.faction = element.at("faction");
-    investigator.traits = element.at("traits");
-    investigator.subname = element.at("subname");
-    investigator.skill.willpower = element.at("skill_willpower");
-    investigator.skill.intellect = element.at("skill_intellect");
-    investigator.skill.combat = element.at("skill_combat");
-    investigator.skill.agility = element.at("skill_agility");
-    investigator.health = element.at("health");
-    investigator.sanity = element.at("sanity");
-    investigators.insert({investigator.name, investigator});
+    const auto [it, inserted] = pool.codes.try_emplace(card.code, pool.cards.size());
+    if (inserted)
+      pool.cards.push_back(std::move(card));
+    else
+      pool.cards[it->second] = std::move(card);
   }
+  pool.index = CardPoolIndex{pool.cards};
 }
 
-void ReadActionDBData(const nlohmann::json& elements, std::vector<CardDB::ActionDBData>& actions)
+std::optional<EffectSpec> CardDB::CompileEffect(const ActionDBData& action)
 {
-  for (const auto& sub_element: elements)
+  auto get_modification = [&action](const std::string_view key) -> std::optional<int8_t>
+  {
+    if (const auto it = action.modifications.find(key); it != action.modifications.end())
+      return std::get<int8_t>(it->second);
+    return std::nullopt;
+  };
+
+  EffectSpec spec;
+  spec.skill = action.skill_effect.skill;
+  spec.activationCost = action.expend.value_or(0);
+  if (action.action == "fight")
   {
-    CardDB::ActionDBData activate_action;
-    const auto activate_element = sub_element;
-    if (auto activate_it = activate_element.find("expend"); activate_it != activate_element.end())
-      activate_action.expend = activate_it.value();
-    if (auto activate_it = activate_element.find("action"); activate_it != activate_element.end())
-      activate_action.action = activate_it.value();
-
-    if (auto activate_it = activate_element.find("skills"); activate_it != activate_element.end())
+    const auto damage = get_modification("damage");
+    if (action.skill_effect.optional_effect.has_value() && action.skill_effect.optional_effect->what == "location")
     {
-      const auto skills_element = activate_it.value();
-      if (auto skills_it = skills_element.find("combat"); skills_it != skills_element.end())
-        activate_action.skill_effect.skill.combat = skills_it.value();
-      if (auto skills_it = skills_element.find("willpower"); skills_it != skills_element.end())
-        activate_action.skill_effect.skill.willpower = skills_it.value();
-      if (auto skills_it = skills_element.find("optional"); skills_it != skills_element.end())
-      {
-        CardDB::ActionDBData::SkillEffectsDBData::OptionalEffectDBData optional_effect;
-        auto optional_element = skills_it.value();
-        if (auto optional_it = optional_element.find("combat"); optional_it != optional_element.end())
-          optional_effect.skill.combat = optional_it.value();
-        if (auto optional_it = optional_element.find("location"); optional_it != optional_element.end())
-        {
-          optional_effect.what = optional_it.key();
-          optional_effect.condition = optional_it.value();
-        }
-        activate_action.skill_effect.optional_effect = optional_effect;
-      }
+      spec.kind = EffectKind::kLocationOptionalFight;
+      spec.amount = damage.value_or(0);
+      spec.optionalSkill = action.skill_effect.optional_effect->skill;
+      spec.locationCondition =
+        StringToEnum::Get<LocationOptionalEffectCondition>(action.skill_effect.optional_effect->condition);
     }
-
-    if (auto activate_it = activate_element.find("modifications"); activate_it != activate_element.end())
+    else if (damage.has_value())
     {
-      const auto effect_array = activate_it.value();
-      for (const auto& effect_element: effect_array)
+      spec.amount = damage.value();
+      spec.kind = EffectKind::kFightWithAdditionalDamage;
+      if (const auto it = action.modifications.find("condition"); it != action.modifications.end())
       {
-        for (const auto [key, value]: effect_element.items())
-        {
-          if (key == "condition")
-            activate_action.modifications.insert({key, static_cast<std::string>(value)});
-          else
-            activate_action.modifications.insert({key, static_cast<int8_t>(value)});
-        }
+        spec.kind = EffectKind::kFightWithAdditionalDamageWithCondition;
+        spec.condition = std::get<std::string_view>(it->second) == "only_enemy_engaged" ?
+                           EffectCondition::kOnlyEnemyEngaged :
+                           EffectCondition::kNone;
       }
     }
-
-    if (auto action_it = activate_element.find("target"); action_it != activate_element.end())
+  }
+  else if (action.action == "skill_test")
+  {
+    spec.kind = EffectKind::kSkillTest;
+  }
+  else if (action.action == "investigate")
+  {
+    if (const auto shroud = get_modification("shroud"); shroud.has_value())
     {
-      activate_action.target = action_it.value();
+      spec.kind = EffectKind::kInvestigateWithShroudModification;
+      spec.amount = shroud.value();
     }
-
-    actions.push_back(activate_action);
   }
-}
-
-void ReadAssetObject(const nlohmann::json& object,
-                     std::unordered_map<std::string, CardDB::AssetCardDBData>& assets)
-{
-  for (const auto& element: object)
+  else if (action.action == "make_damage")
   {
-    CardDB::AssetCardDBData asset;
-    asset.name = element.at("name");
-    asset.faction = element.at("faction");
-    asset.traits = element.at("traits");
-    asset.cost = element.at("cost");
-    asset.skill = ReadSkillObject(element.at("test_skill"));
-    if (auto it = element.find("slot"); it != element.end())
-      asset.slot = element.at("slot");
-    if (auto it = element.find("uses"); it != element.end())
-      asset.uses = element.at("uses");
-    if (auto it = element.find("health"); it != element.end())
-      asset.health = element.at("health");
-    if (auto it = element.find("sanity"); it != element.end())
-      asset.sanity = element.at("sanity");
-
-    if (const auto it = element.find("activate"); it != element.end())
+    if (const auto damage = get_modification("damage"); damage.has_value())
     {
-      ReadActionDBData(it.value(), asset.effects.at(EffectType::kActivate));
+      spec.kind = EffectKind::kMakeDamageAtTargetAtCurrentLocation;
+      spec.amount = damage.value();
     }
-
-    if (const auto it = element.find("trigger"); it != element.end())
+  }
+  else if (action.action == "recive_damage")
+  {
+    if (const auto damage = get_modification("damage"); damage.has_value() && action.target == "attacking_enemy")
     {
-      ReadActionDBData(it.value(), asset.effects.at(EffectType::kTrigger));
+      spec.kind = EffectKind::kMakeDamageToAttacker;
+      spec.amount = damage.value();
     }
+  }
 
-    if (const auto it = element.find("discard"); it != element.end())
-    {
-      ReadActionDBData(it.value(), asset.effects.at(EffectType::kDiscard));
-    }
+  if (spec.kind == EffectKind::kInvalid)
+    return std::nullopt;
+  return spec;
+}
 
-    if (const auto it = element.find("pasive"); it != element.end())
+void CardDB::CompileEffects(AssetCardDBData& asset)
+{
+  for (size_t type = 0; type < kEffectTypeCount; ++type)
+  {
+    auto& specs = asset.compiled_effects[static_cast<EffectType>(type)];
+    specs.clear();
+    for (const auto& action: asset.effects[static_cast<EffectType>(type)])
     {
-      ReadActionDBData(it.value(), asset.effects.at(EffectType::kPasive));
+      if (auto spec = CompileEffect(action); spec.has_value())
+        specs.push_back(spec.value());
     }
-
-    assets.insert({asset.name, asset});
   }
 }
 
-void CardDB::ReadFile()
+void CardDB::LoadArkhamDB(const std::string& path)
 {
-  using json = nlohmann::json;
-  std::fstream cardsFile{kCardFilePath};
-  json cardsData = json::parse(cardsFile);
-  for (const auto& [key, val]: cardsData.items())
+  auto is_loaded = [&path](const Snapshot& snapshot)
   {
-    if (key == kInvestigatorsKey)
-    {
-      ReadInvestigatorsObject(val, mInvestigators);
-    }
-    else if (key == kAssetsKey)
-    {
-      ReadAssetObject(val, mAssets);
-    }
-  }
-}
\ No newline at end of file
+    const auto& files = snapshot.GetArkhamDBFiles();
+    return std::find(files.begin(), files.end(), path) != files.end();
+  };
+  if (is_loaded(*ReadSnapshot()))
+    return;
+
+  std::vector<ArkhamDBCardData> cards;
+  ArkhamDBReader::Read(path, cards);
+  const auto count = cards.size();
+
+  const std::lock_guard lock{mWriteMutex};
+  // Loaded by another thread while this one was reading it
+  if (is_loaded(*mOwner))
+    return;
+  // The default dump is read first so that the cards of this file replace its cards
+  auto pool = mOwner->GetArkhamDB();
+  MergeArkhamDB(pool, std::move(cards));
+  auto files = mOwner->GetArkhamDBFiles();
+  files.push_back(path);
+  Publish(std::make_shared<const Snapshot>(*mOwner, std::move(pool), std::move(files)));
+  spdlog::info("{} arkhamdb cards read from '{}'", count, path);
+}
@@ -1,71 +1,225 @@
 #pragma once
 #include "asset.h"
 #include "card.h"
+#include "card_db_data.h"
+#include "card_db_reader.h"
+#include "card_id.h"
+#include "card_pool_index.h"
+#include "epoch_reclaimer.h"
 #include "investigator.h"
+#include "mapped_file.h"
+#include "perfect_hash.h"
+#include "string_interner.h"
 
-#include <variant>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
 
+// Card data shared by every game and simulation thread. The data lives in immutable snapshots published through an
+// atomic pointer: ReadSnapshot pins the current one with an EpochReclaimer guard, without a lock or a reference
+// count, and Reload publishes a new one with a single store. The replaced snapshot is retired and dropped once no
+// guard can see it. Games in flight hold a GetSnapshot reference instead and keep their snapshot until they finish
 class CardDB
 {
 public:
   static inline const std::string kCardFilePath = "data/cards.json";
+  // Built from kCardFilePath by ArkhamHorror_CardCompiler, used instead of it when present
+  static inline const std::string kCardImagePath = "data/cards.bin";
+  // Full arkhamdb dump, streamed when present unless the card data is embedded, then it has to be passed to
+  // LoadArkhamDB. Only used for the card pool, the playable cards come from kCardFilePath
+  static inline const std::string kArkhamDBFilePath = "data/cards_db.json";
 
-  struct CardDBData
+  using CardDBData = ::CardDBData;
+  using InvestigatorCardDBData = ::InvestigatorCardDBData;
+  using ActionDBData = ::ActionDBData;
+  using AssetCardDBData = ::AssetCardDBData;
+
+  // Where the sections of a snapshot are read from: the embedded tables, the mapped card image or the json file.
+  // Opening it only finds where the sections are. The image stays mapped as long as the source, so its sections
+  // are read in place
+  class Source
   {
-    std::string name;
-    std::string faction;
-    std::string traits;
+  public:
+    // The embedded tables, else kCardImagePath if present, else kCardFilePath
+    static std::shared_ptr<const Source> Open();
+    // A card image, or a card json file when path ends in .json, whether or not the cards are embedded
+    static std::shared_ptr<const Source> Open(const std::string& path);
+    void ReadSection(CardSection section, CardDBTables& tables) const;
+
+  private:
+    std::unique_ptr<MappedFile> mImage;
+    std::optional<CardDBReader::SectionIndex> mJsonIndex;
   };
 
-  struct InvestigatorCardDBData: public CardDBData
+  // Value built the first time it is needed, by whichever thread gets there first. Later reads only check a flag
+  template<typename T>
+  class LazySection
   {
-    std::string subname;
-    Skill skill;
-    uint8_t health{0};
-    uint8_t sanity{0};
+  public:
+    template<typename Build>
+    const T& Get(Build&& build) const
+    {
+      std::call_once(mOnce, [this, &build]() {
+        mValue = build();
+        mLoaded.store(true, std::memory_order_release);
+      });
+      return mValue;
+    }
+
+    bool IsLoaded() const
+    {
+      return mLoaded.load(std::memory_order_acquire);
+    }
+
+  private:
+    mutable std::once_flag mOnce;
+    mutable T mValue;
+    mutable std::atomic<bool> mLoaded{false};
   };
 
-  struct ActionDBData
+  // Sorted by name, the position of a name in the perfect hash is the index of its card. The hash keys are the
+  // interned names of the cards
+  template<typename T>
+  struct CardSectionData
   {
-    // Si gasta recursos asignados, si no tiene asignados entonces son resources del jugador
-    std::optional<uint8_t> expend{std::nullopt};
-    // Accion a la que afecta : lucha / skill_test
-    std::string action;
-    struct SkillEffectsDBData
-    {
-      Skill skill; // Valor que añade a las skills
-      struct OptionalEffectDBData
-      {
-        Skill skill;           // Valor que añade a las skills
-        std::string what;      // Que afecta: "lugar"
-        std::string condition; // Condicion de que afecta: "undiscovered_clues"
-      };
-      // Modificacion de la skill si se cumple la condicion (estar en un lugar sin pistas descubiertas)
-      std::optional<OptionalEffectDBData> optional_effect;
-    };
-    SkillEffectsDBData skill_effect;
-    // Efecto extra sobre la accion: para la lucha puede ser +1 de daño
-    std::unordered_map<std::string, std::variant<int8_t, std::string>> modifications;
-    // Target For modifications
-    std::string target;
+    PerfectHash index;
+    std::vector<std::shared_ptr<const T>> cards;
   };
 
-  struct AssetCardDBData: public CardDBData
+  struct ArkhamDBPool
   {
-    AssetCardDBData()
+    std::vector<ArkhamDBCardData> cards;
+    std::unordered_map<std::string, size_t> codes;
+    CardPoolIndex index; // Positions in cards
+  };
+
+  // Immutable card data, safe to read from any number of threads. Sections are read the first time one of their
+  // cards is needed, cards are built once and every caller shares the same immutable prototype. Per game state
+  // lives in small records created from it (see AssetState)
+  class Snapshot: public std::enable_shared_from_this<Snapshot>
+  {
+  public:
+    // The arkhamdb pool is read from arkhamDBFiles the first time it is queried, a later file replaces the cards
+    // of the earlier ones with the same code
+    Snapshot(std::shared_ptr<const Source> source, std::vector<std::string> arkhamDBFiles):
+      mSource{std::move(source)},
+      mInvestigators{std::make_shared<LazySection<CardSectionData<Investigator>>>()},
+      mAssets{std::make_shared<LazySection<CardSectionData<Card>>>()},
+      mArkhamDBFiles{std::move(arkhamDBFiles)},
+      mArkhamDB{std::make_shared<LazySection<ArkhamDBPool>>()}
+    {}
+
+    // Same cards with another arkhamdb pool, already read from arkhamDBFiles
+    Snapshot(const Snapshot& snapshot, ArkhamDBPool arkhamDB, std::vector<std::string> arkhamDBFiles):
+      mSource{snapshot.mSource},
+      mInvestigators{snapshot.mInvestigators},
+      mAssets{snapshot.mAssets},
+      mArkhamDBFiles{std::move(arkhamDBFiles)},
+      mArkhamDB{std::make_shared<LazySection<ArkhamDBPool>>()}
+    {
+      mArkhamDB->Get([&arkhamDB]() { return std::move(arkhamDB); });
+    }
+
+    // Id of a card in the card table, kInvalidCardId if there is no card with that name. Ids follow the
+    // alphabetical order of the names, a lookup is one probe of the perfect hash of the names
+    CardId GetCardId(const std::string_view name) const
+    {
+      const auto index = GetAssets().index.Lookup(name);
+      return index == PerfectHash::kNotFound ? kInvalidCardId : static_cast<CardId>(index);
+    }
+
+    // Immutable card shared by every deck, hand and commit list holding its id, valid while the snapshot is held
+    const std::shared_ptr<const Card>& GetCardById(const CardId id) const
+    {
+      return GetAssets().cards.at(id);
+    }
+
+    size_t GetCardTableSize() const
+    {
+      return GetAssets().cards.size();
+    }
+
+    bool IsSectionLoaded(const CardSection section) const
+    {
+      switch (section)
+      {
+        case CardSection::kInvestigators: return mInvestigators->IsLoaded();
+        case CardSection::kAssets: return mAssets->IsLoaded();
+        default: return false;
+      }
+    }
+
+    template<typename T>
+    std::shared_ptr<const T> GetCard(const std::string_view) const
     {
-      effects.insert({EffectType::kActivate, {}});
-      effects.insert({EffectType::kTrigger, {}});
-      effects.insert({EffectType::kPasive, {}});
-      effects.insert({EffectType::kDiscard, {}});
+      return nullptr;
+    }
+
+    template<>
+    std::shared_ptr<const Investigator> GetCard(const std::string_view name) const
+    {
+      const auto& investigators = GetInvestigators();
+      const auto index = investigators.index.Lookup(name);
+      return index == PerfectHash::kNotFound ? nullptr : investigators.cards[index];
+    }
+
+    template<>
+    std::shared_ptr<const Asset> GetCard(const std::string_view name) const
+    {
+      const auto id = GetCardId(name);
+      return id == kInvalidCardId ? nullptr : std::static_pointer_cast<const Asset>(GetCardById(id));
+    }
+
+    // Card of the arkhamdb pool, nullptr if no loaded file has that code
+    const ArkhamDBCardData* GetArkhamDBCard(const std::string& code) const
+    {
+      const auto& pool = GetArkhamDB();
+      const auto it = pool.codes.find(code);
+      return it == pool.codes.end() ? nullptr : &pool.cards[it->second];
+    }
+
+    const std::vector<ArkhamDBCardData>& GetArkhamDBCards() const
+    {
+      return GetArkhamDB().cards;
+    }
+
+    // Deckbuilding query over the arkhamdb pool, the positions it gives are in GetArkhamDBCards. Valid while the
+    // snapshot is held
+    CardPoolIndex::Query FindArkhamDBCards() const
+    {
+      return GetArkhamDB().index.Find();
+    }
+
+    const ArkhamDBPool& GetArkhamDB() const
+    {
+      return mArkhamDB->Get([this]() { return ReadArkhamDB(mArkhamDBFiles); });
+    }
+
+    // Files the arkhamdb pool is made of, in the order they were merged
+    const std::vector<std::string>& GetArkhamDBFiles() const
+    {
+      return mArkhamDBFiles;
     }
-    uint8_t cost{0};                                                   // Coste de la carta
-    Skill skill;                                                       // Habilidades para skill tests
-    std::optional<std::string> slot;                                   // Espacio que ocupa si lo tiene
-    std::optional<uint8_t> uses{std::nullopt};                         // Usos si tiene
-    std::unordered_map<EffectType, std::vector<ActionDBData>> effects; // Efectos
-    uint8_t health{0};
-    uint8_t sanity{0};
+
+  private:
+    const CardSectionData<Investigator>& GetInvestigators() const
+    {
+      return mInvestigators->Get([this]() { return BuildInvestigators(*mSource); });
+    }
+
+    const CardSectionData<Card>& GetAssets() const
+    {
+      return mAssets->Get([this]() { return BuildAssets(*mSource); });
+    }
+
+    std::shared_ptr<const Source> mSource;
+    // Shared with the snapshots made from this one by LoadArkhamDB, their cards are the same
+    std::shared_ptr<LazySection<CardSectionData<Investigator>>> mInvestigators;
+    std::shared_ptr<LazySection<CardSectionData<Card>>> mAssets;
+    std::vector<std::string> mArkhamDBFiles;
+    std::shared_ptr<LazySection<ArkhamDBPool>> mArkhamDB;
   };
 
   static inline CardDB& Instance()
@@ -74,37 +228,156 @@ public:
     return instance;
   }
 
+  // Current snapshot pinned for a read on this thread. The guard makes no lock and no reference count, so any
+  // number of threads can read at once; the snapshot stays valid until the guard is destroyed, on the same thread
+  class SnapshotGuard
+  {
+  public:
+    explicit SnapshotGuard(const std::atomic<const Snapshot*>& current):
+      mGuard{EpochReclaimer::Instance()},
+      mSnapshot{current.load(std::memory_order_seq_cst)}
+    {}
+
+    const Snapshot& operator*() const
+    {
+      return *mSnapshot;
+    }
+
+    const Snapshot* operator->() const
+    {
+      return mSnapshot;
+    }
+
+  private:
+    EpochReclaimer::Guard mGuard; // Pinned before the pointer is loaded
+    const Snapshot* mSnapshot;
+  };
+
+  // Code that looks up many cards should take it once rather than go through the lookups below one by one. Card
+  // ids held past the read are resolved from the snapshot they were taken from (see GetSnapshot)
+  SnapshotGuard ReadSnapshot() const
+  {
+    return SnapshotGuard{mCurrent};
+  }
+
+  // Current snapshot for code that keeps it past a read, like a game in flight: a Reload does not change the cards
+  // it sees. Costs a reference count, simulation loops use ReadSnapshot or pass the snapshot they hold
+  std::shared_ptr<const Snapshot> GetSnapshot() const
+  {
+    return ReadSnapshot()->shared_from_this();
+  }
+
+  // Opens the default card source again and publishes a new snapshot of it. The arkhamdb files merged so far are
+  // read again with it. Holders of the previous snapshot are not affected. With embedded cards the default source
+  // is the tables built into the binary, which never change: use Reload(path) for card errata there
+  void Reload()
+  {
+    ReloadFrom(Source::Open());
+  }
+
+  // Same, but the cards are read from a card image or a card json file (see Source::Open), in every build. A later
+  // Reload() goes back to the default source
+  void Reload(const std::string& path)
+  {
+    ReloadFrom(Source::Open(path));
+  }
+
+  // Goes back to the default source and the default arkhamdb files, as the CardDB starts. For the tests, which
+  // share the process wide instance and drop what they loaded with it
+  void Reset()
+  {
+    const std::lock_guard lock{mWriteMutex};
+    Publish(std::make_shared<const Snapshot>(Source::Open(), GetDefaultArkhamDBFiles()));
+  }
+
+  CardId GetCardId(const std::string_view name) const
+  {
+    return ReadSnapshot()->GetCardId(name);
+  }
+
+  // By value, the card outlives the snapshot if a Reload replaces it meanwhile
+  std::shared_ptr<const Card> GetCardById(const CardId id) const
+  {
+    return ReadSnapshot()->GetCardById(id);
+  }
+
+  size_t GetCardTableSize() const
+  {
+    return ReadSnapshot()->GetCardTableSize();
+  }
+
+  bool IsSectionLoaded(const CardSection section) const
+  {
+    return ReadSnapshot()->IsSectionLoaded(section);
+  }
+
   template<typename T>
-  std::shared_ptr<T> GetCard(const std::string&)
+  std::shared_ptr<const T> GetCard(const std::string_view name) const
   {
-    return nullptr;
+    return ReadSnapshot()->template GetCard<T>(name);
   }
 
-  template<>
-  std::shared_ptr<Investigator> GetCard(const std::string& name)
+  // Streams an arkhamdb dump or pack file into the card pool of a new snapshot. A card whose code is already in
+  // the pool replaces it. The file is read again by every later Reload, loading it again does nothing
+  void LoadArkhamDB(const std::string& path);
+
+  // Resolves the action names, conditions and modifications of the card data into EffectSpecs. Actions that do
+  // not build any effect compile to nothing
+  static std::optional<EffectSpec> CompileEffect(const ActionDBData& action);
+  static void CompileEffects(AssetCardDBData& asset);
+
+  // Copy of a card of the arkhamdb pool
+  std::optional<ArkhamDBCardData> GetArkhamDBCard(const std::string& code) const
   {
-    const auto& it = mInvestigators.find(name);
-    if (it == mInvestigators.end())
-      return nullptr;
+    const auto snapshot = ReadSnapshot();
+    const auto* card = snapshot->GetArkhamDBCard(code);
+    return card == nullptr ? std::nullopt : std::optional<ArkhamDBCardData>{*card};
+  }
+
+private:
+  // Only opens the source, each section is read and built the first time one of its cards is needed
+  CardDB()
+  {
+    // Built first so that it outlives CardDB, the snapshots it still holds are dropped after ours
+    EpochReclaimer::Instance();
+    Publish(std::make_shared<const Snapshot>(Source::Open(), GetDefaultArkhamDBFiles()));
+  }
+
+  ~CardDB() noexcept = default;
 
-    const auto& [_, dbData] = *it;
+  void ReloadFrom(std::shared_ptr<const Source> source)
+  {
+    const std::lock_guard lock{mWriteMutex};
+    Publish(std::make_shared<const Snapshot>(std::move(source), mOwner->GetArkhamDBFiles()));
+  }
+
+  // Callers hold mWriteMutex, except the constructor. Readers pinned before the store may still read the previous
+  // snapshot, it is retired rather than dropped
+  void Publish(std::shared_ptr<const Snapshot> snapshot)
+  {
+    mCurrent.store(snapshot.get(), std::memory_order_seq_cst);
+    if (auto previous = std::exchange(mOwner, std::move(snapshot)))
+      EpochReclaimer::Instance().Retire(std::move(previous));
+  }
+
+  static std::vector<std::string> GetDefaultArkhamDBFiles();
+  static ArkhamDBPool ReadArkhamDB(const std::vector<std::string>& files);
+  static void MergeArkhamDB(ArkhamDBPool& pool, std::vector<ArkhamDBCardData> cards);
+
+  static std::shared_ptr<Investigator> BuildInvestigator(const std::string_view name,
+                                                         const InvestigatorCardDBData& dbData)
+  {
     auto investigator = std::make_shared<Investigator>(name,
                                                        StringToEnum::Get<Faction>(dbData.faction),
                                                        dbData.skill,
                                                        dbData.health,
                                                        dbData.sanity);
+    investigator->SetTraits(TraitRegistry::Instance().Parse(dbData.traits));
     return investigator;
   }
 
-  template<>
-  std::shared_ptr<Asset> GetCard(const std::string& name)
+  static std::shared_ptr<Asset> BuildAsset(const std::string_view name, const AssetCardDBData& dbData)
   {
-    const auto& it = mAssets.find(name);
-    if (it == mAssets.end())
-      return nullptr;
-
-    const auto& [_, dbData] = *it;
-
     auto asset = std::make_shared<Asset>(name,
                                          StringToEnum::Get<Faction>(dbData.faction),
                                          dbData.skill,
@@ -114,130 +387,86 @@ public:
                                          dbData.uses,
                                          dbData.health,
                                          dbData.sanity);
+    asset->SetTraits(TraitRegistry::Instance().Parse(dbData.traits));
 
-    auto register_effect = [&](const std::vector<ActionDBData>& actions,
-                               std::function<void(const std::shared_ptr<Effect>&)> register_function)
+    auto register_effect = [&](const EffectType type,
+                               std::function<void(EffectVariant)> register_function)
     {
-      for (const auto& action: actions)
-      {
-        Skill mainSkill = action.skill_effect.skill;
-        if (action.action == "fight")
-        {
-          if (action.skill_effect.optional_effect.has_value()
-              && action.skill_effect.optional_effect->what == "location")
-          {
-            Skill optionalSkill = action.skill_effect.optional_effect->skill;
-            std::shared_ptr<Effect> effect = std::make_shared<LocationOptionalFightEffectWithAdditionalDamage>(
-              mainSkill,
-              action.expend.value_or(0),
-              static_cast<uint8_t>(std::get<int8_t>(action.modifications.find("damage")->second)),
-              LocationOptionalEffect{mainSkill,
-                                     action.expend.value_or(0),
-                                     optionalSkill,
-                                     StringToEnum::Get<LocationOptionalEffectCondition>(
-                                       action.skill_effect.optional_effect->condition)});
-            register_function(effect);
-          }
-          // No optional effect
-          else
-          {
-            if (action.modifications.find("damage") != action.modifications.end())
-            {
-              uint8_t damage = static_cast<uint8_t>(std::get<int8_t>(action.modifications.find("damage")->second));
-              if (action.modifications.find("condition") == action.modifications.end())
-              {
-                std::shared_ptr<Effect> effect =
-                  std::make_shared<FightEffectWithAdditionalDamage>(mainSkill, action.expend.value_or(0), damage);
-                register_function(effect);
-              }
-              else
-              {
-                std::shared_ptr<Condition> condition;
-                if (std::get<std::string>(action.modifications.find("condition")->second) == "only_enemy_engaged")
-                {
-                  condition = std::make_shared<OnlyEnemyEngaged>();
-                }
-                std::shared_ptr<Effect> effect =
-                  std::make_shared<FightEffectWithAdditionalDamageWithCondition>(mainSkill,
-                                                                                 action.expend.value_or(0),
-                                                                                 damage,
-                                                                                 condition);
-                register_function(effect);
-              }
-            }
-          }
-        }
-        else if (action.action == "skill_test")
-        {
-          auto effect = std::make_shared<Effect>(mainSkill, action.expend.value_or(0));
-          register_function(effect);
-        }
-        else if (action.action == "investigate")
-        {
-          if (auto it = action.modifications.find("shroud"); it != action.modifications.end())
-          {
-            auto effect = std::make_shared<InvestigateEffectWithShroudModification>(mainSkill,
-                                                                                    action.expend.value_or(0),
-                                                                                    std::get<int8_t>(it->second));
-            register_function(effect);
-          }
-        }
-        else if (action.action == "make_damage")
-        {
-          if (auto it = action.modifications.find("damage"); it != action.modifications.end())
-          {
-            auto effect = std::make_shared<MakeDamageAtTargetAtCurrentLocation>(
-              mainSkill,
-              action.expend.value_or(0),
-              static_cast<uint8_t>(std::get<int8_t>(it->second)));
-            register_function(effect);
-          }
-        }
-        else if (action.action == "recive_damage")
-        {
-          if (auto it = action.modifications.find("damage"); it != action.modifications.end())
-          {
-            if (action.target == "attacking_enemy")
-            {
-              auto effect =
-                std::make_shared<MakeDamageToAttacker>(mainSkill,
-                                                       action.expend.value_or(0),
-                                                       static_cast<uint8_t>(std::get<int8_t>(it->second)));
-              register_function(effect);
-            }
-          }
-        }
-      }
+      for (const auto& spec: dbData.compiled_effects[type])
+        register_function(MakeEffect(spec));
     };
 
-    register_effect(dbData.effects.at(EffectType::kActivate),
-                    [&asset](const std::shared_ptr<Effect>& effect) { asset->RegisterActivationEffect(effect); });
+    register_effect(EffectType::kActivate,
+                    [&asset](EffectVariant effect) { asset->RegisterActivationEffect(std::move(effect)); });
 
-    register_effect(dbData.effects.at(EffectType::kTrigger),
-                    [&asset](const std::shared_ptr<Effect>& effect) { asset->RegisterTriggerEffect(effect); });
+    register_effect(EffectType::kTrigger,
+                    [&asset](EffectVariant effect) { asset->RegisterTriggerEffect(std::move(effect)); });
 
-    register_effect(dbData.effects.at(EffectType::kDiscard),
-                    [&asset](const std::shared_ptr<Effect>& effect) { asset->RegisterDiscardEffect(effect); });
+    register_effect(EffectType::kDiscard,
+                    [&asset](EffectVariant effect) { asset->RegisterDiscardEffect(std::move(effect)); });
 
-    register_effect(dbData.effects.at(EffectType::kPasive),
-                    [&asset](const std::shared_ptr<Effect>& effect) { asset->RegisterPasiveEffect(effect); });
+    register_effect(EffectType::kPasive,
+                    [&asset](EffectVariant effect) { asset->RegisterPasiveEffect(std::move(effect)); });
 
     return asset;
   }
 
-private:
-  CardDB()
+  // Builds every asset once, ids follow the alphabetical order of the names so they are stable between runs
+  static CardSectionData<Card> BuildAssets(const Source& source)
   {
-    ReadFile();
+    CardDBTables tables;
+    source.ReadSection(CardSection::kAssets, tables);
+    if (tables.assets.size() >= kInvalidCardId)
+      throw std::runtime_error(fmt::format("Card table can not hold {} cards", tables.assets.size()));
+
+    std::vector<std::string_view> names;
+    names.reserve(tables.assets.size());
+    std::transform(tables.assets.begin(),
+                   tables.assets.end(),
+                   std::back_inserter(names),
+                   [](const auto& it) { return it.first; });
+    std::sort(names.begin(), names.end());
+
+    CardSectionData<Card> section;
+    for (const auto& name: names)
+      section.cards.push_back(BuildAsset(name, tables.assets.at(name)));
+    IndexNames(section);
+    return section;
   }
 
-  ~CardDB() noexcept = default;
+  static CardSectionData<Investigator> BuildInvestigators(const Source& source)
+  {
+    CardDBTables tables;
+    source.ReadSection(CardSection::kInvestigators, tables);
+
+    std::vector<std::string_view> names;
+    for (const auto& [name, _]: tables.investigators)
+      names.push_back(name);
+    std::sort(names.begin(), names.end());
 
-  static inline const std::string kInvestigatorsKey{"investigators"};
-  static inline const std::string kAssetsKey{"assets"};
+    CardSectionData<Investigator> section;
+    for (const auto& name: names)
+      section.cards.push_back(BuildInvestigator(name, tables.investigators.at(name)));
+    IndexNames(section);
+    return section;
+  }
 
-  void ReadFile();
+  template<typename T>
+  static void IndexNames(CardSectionData<T>& section)
+  {
+    std::vector<std::string_view> names;
+    names.reserve(section.cards.size());
+    std::transform(section.cards.begin(),
+                   section.cards.end(),
+                   std::back_inserter(names),
+                   [](const auto& card) { return card->GetName(); });
+    section.index = PerfectHash{std::move(names)};
+  }
 
-  std::unordered_map<std::string, InvestigatorCardDBData> mInvestigators;
-  std::unordered_map<std::string, AssetCardDBData> mAssets;
-};
\ No newline at end of file
+  std::atomic<const Snapshot*> mCurrent{nullptr};
+  static_assert(std::atomic<const Snapshot*>::is_always_lock_free);
+  // Keeps the current snapshot alive, written under mWriteMutex
+  std::shared_ptr<const Snapshot> mOwner;
+  // Serializes the writers, readers never take it
+  std::mutex mWriteMutex;
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "effect.h"
+#include "effect_spec.h"
+#include "skill.h"
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+// Raw card data as it is read from the card files, before building the cards. The text is not copied: it points
+// into the mapped card image or the embedded tables, which are read in place, or into the strings of the
+// CardDBTables it was read into when the source has to decode it (the json file)
+struct CardDBData
+{
+  std::string_view name;
+  std::string_view faction;
+  std::string_view traits;
+};
+
+struct InvestigatorCardDBData: public CardDBData
+{
+  std::string_view subname;
+  Skill skill;
+  uint8_t health{0};
+  uint8_t sanity{0};
+};
+
+struct ActionDBData
+{
+  // Si gasta recursos asignados, si no tiene asignados entonces son resources del jugador
+  std::optional<uint8_t> expend{std::nullopt};
+  // Accion a la que afecta : lucha / skill_test
+  std::string_view action;
+  struct SkillEffectsDBData
+  {
+    Skill skill; // Valor que añade a las skills
+    struct OptionalEffectDBData
+    {
+      Skill skill;           // Valor que añade a las skills
+      std::string_view what;      // Que afecta: "lugar"
+      std::string_view condition; // Condicion de que afecta: "undiscovered_clues"
+    };
+    // Modificacion de la skill si se cumple la condicion (estar en un lugar sin pistas descubiertas)
+    std::optional<OptionalEffectDBData> optional_effect;
+  };
+  SkillEffectsDBData skill_effect;
+  // Efecto extra sobre la accion: para la lucha puede ser +1 de daño
+  std::unordered_map<std::string_view, std::variant<int8_t, std::string_view>> modifications;
+  // Target For modifications
+  std::string_view target;
+};
+
+struct AssetCardDBData: public CardDBData
+{
+  uint8_t cost{0};                                                   // Coste de la carta
+  Skill skill;                                                       // Habilidades para skill tests
+  std::optional<std::string_view> slot;                              // Espacio que ocupa si lo tiene
+  std::optional<uint8_t> uses{std::nullopt};                         // Usos si tiene
+  EffectTable<std::vector<ActionDBData>> effects;                    // Efectos
+  // The effects compiled once when the section is read, the cards are built from these
+  EffectTable<SmallVector<EffectSpec, 1>> compiled_effects;
+  uint8_t health{0};
+  uint8_t sanity{0};
+};
+
+// Top level sections of the card data. CardDB reads each one the first time a card of its type is needed
+enum class CardSection
+{
+  kInvestigators,
+  kAssets,
+  kInvalid
+};
+
+// Everything read from one card source. Move only, the text of the cards may point into its strings
+struct CardDBTables
+{
+  CardDBTables() = default;
+  CardDBTables(CardDBTables&&) = default;
+  CardDBTables& operator=(CardDBTables&&) = default;
+  CardDBTables(const CardDBTables&) = delete;
+  CardDBTables& operator=(const CardDBTables&) = delete;
+
+  // Keeps text that can not be read in place, a deque never moves its elements so the view stays valid
+  std::string_view Store(std::string value)
+  {
+    return strings.emplace_back(std::move(value));
+  }
+
+  std::unordered_map<std::string_view, InvestigatorCardDBData> investigators;
+  std::unordered_map<std::string_view, AssetCardDBData> assets;
+  std::deque<std::string> strings;
+  // Memory the text points into when nothing else keeps it, like the mapped image of CardImage::ReadFile
+  std::shared_ptr<const void> storage;
+};
+
+// Card of an arkhamdb dump (data/cards_db.json or any pack file), of any type: investigator, asset, event, skill,
+// enemy, treachery, location, act, agenda... Fields a type does not use stay empty.
+struct ArkhamDBCardData
+{
+  std::string code;
+  std::string name;
+  std::string subname;
+  std::string type_code;
+  std::string subtype_code;
+  std::string faction_code;
+  std::string pack_code;
+  std::string traits;
+  std::string slot;
+  std::string text;
+  std::optional<int8_t> cost;
+  uint8_t xp{0};
+  uint8_t quantity{0};
+  Skill skill; // Icons for skill tests, investigator skills for investigators
+  std::optional<uint8_t> health;
+  std::optional<uint8_t> sanity;
+  std::optional<uint8_t> enemy_fight;
+  std::optional<uint8_t> enemy_evade;
+  std::optional<uint8_t> enemy_damage;
+  std::optional<uint8_t> enemy_horror;
+  std::optional<uint8_t> shroud;
+  std::optional<uint8_t> clues;
+  std::optional<uint8_t> doom;
+  std::optional<uint8_t> victory;
+};
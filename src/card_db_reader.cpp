@@ -0,0 +1,327 @@
+#include "card_db_reader.h"
+
+#include "mapped_file.h"
+#include "nlohmann/json.hpp"
+
+#include <cctype>
+#include <fstream>
+#include <stdexcept>
+
+static Skill ReadSkillObject(const nlohmann::json& object)
+{
+  Skill skill;
+  if (auto it = object.find("combat"); it != object.end())
+  {
+    skill.combat = it.value();
+  }
+  if (auto it = object.find("agility"); it != object.end())
+  {
+    skill.agility = it.value();
+  }
+  if (auto it = object.find("willpower"); it != object.end())
+  {
+    skill.willpower = it.value();
+  }
+  if (auto it = object.find("intellect"); it != object.end())
+  {
+    skill.intellect = it.value();
+  }
+  if (auto it = object.find("wild"); it != object.end())
+  {
+    skill.wild = it.value();
+  }
+  return skill;
+}
+
+// The json strings are decoded, the tables keep them
+static std::string_view ReadString(const nlohmann::json& value, CardDBTables& tables)
+{
+  return tables.Store(value.get<std::string>());
+}
+
+static void ReadInvestigatorsObject(const nlohmann::json& object, CardDBTables& tables)
+{
+  for (const auto& element: object)
+  {
+    InvestigatorCardDBData investigator;
+    investigator.name = ReadString(element.at("name"), tables);
+    investigator.faction = ReadString(element.at("faction"), tables);
+    investigator.traits = ReadString(element.at("traits"), tables);
+    investigator.subname = ReadString(element.at("subname"), tables);
+    investigator.skill.willpower = element.at("skill_willpower");
+    investigator.skill.intellect = element.at("skill_intellect");
+    investigator.skill.combat = element.at("skill_combat");
+    investigator.skill.agility = element.at("skill_agility");
+    investigator.health = element.at("health");
+    investigator.sanity = element.at("sanity");
+    tables.investigators.insert({investigator.name, investigator});
+  }
+}
+
+static void ReadActionDBData(const nlohmann::json& elements,
+                             std::vector<ActionDBData>& actions,
+                             CardDBTables& tables)
+{
+  for (const auto& sub_element: elements)
+  {
+    ActionDBData activate_action;
+    const auto activate_element = sub_element;
+    if (auto activate_it = activate_element.find("expend"); activate_it != activate_element.end())
+      activate_action.expend = activate_it.value();
+    if (auto activate_it = activate_element.find("action"); activate_it != activate_element.end())
+      activate_action.action = ReadString(activate_it.value(), tables);
+
+    if (auto activate_it = activate_element.find("skills"); activate_it != activate_element.end())
+    {
+      const auto skills_element = activate_it.value();
+      if (auto skills_it = skills_element.find("combat"); skills_it != skills_element.end())
+        activate_action.skill_effect.skill.combat = skills_it.value();
+      if (auto skills_it = skills_element.find("willpower"); skills_it != skills_element.end())
+        activate_action.skill_effect.skill.willpower = skills_it.value();
+      if (auto skills_it = skills_element.find("optional"); skills_it != skills_element.end())
+      {
+        ActionDBData::SkillEffectsDBData::OptionalEffectDBData optional_effect;
+        auto optional_element = skills_it.value();
+        if (auto optional_it = optional_element.find("combat"); optional_it != optional_element.end())
+          optional_effect.skill.combat = optional_it.value();
+        if (auto optional_it = optional_element.find("location"); optional_it != optional_element.end())
+        {
+          optional_effect.what = tables.Store(optional_it.key());
+          optional_effect.condition = ReadString(optional_it.value(), tables);
+        }
+        activate_action.skill_effect.optional_effect = optional_effect;
+      }
+    }
+
+    if (auto activate_it = activate_element.find("modifications"); activate_it != activate_element.end())
+    {
+      const auto effect_array = activate_it.value();
+      for (const auto& effect_element: effect_array)
+      {
+        for (const auto& [key, value]: effect_element.items())
+        {
+          if (key == "condition")
+            activate_action.modifications.insert({tables.Store(key), ReadString(value, tables)});
+          else
+            activate_action.modifications.insert({tables.Store(key), static_cast<int8_t>(value)});
+        }
+      }
+    }
+
+    if (auto action_it = activate_element.find("target"); action_it != activate_element.end())
+    {
+      activate_action.target = ReadString(action_it.value(), tables);
+    }
+
+    actions.push_back(activate_action);
+  }
+}
+
+static void ReadAssetObject(const nlohmann::json& object, CardDBTables& tables)
+{
+  for (const auto& element: object)
+  {
+    AssetCardDBData asset;
+    asset.name = ReadString(element.at("name"), tables);
+    asset.faction = ReadString(element.at("faction"), tables);
+    asset.traits = ReadString(element.at("traits"), tables);
+    asset.cost = element.at("cost");
+    asset.skill = ReadSkillObject(element.at("test_skill"));
+    if (auto it = element.find("slot"); it != element.end())
+      asset.slot = ReadString(element.at("slot"), tables);
+    if (auto it = element.find("uses"); it != element.end())
+      asset.uses = element.at("uses");
+    if (auto it = element.find("health"); it != element.end())
+      asset.health = element.at("health");
+    if (auto it = element.find("sanity"); it != element.end())
+      asset.sanity = element.at("sanity");
+
+    if (const auto it = element.find("activate"); it != element.end())
+    {
+      ReadActionDBData(it.value(), asset.effects.at(EffectType::kActivate), tables);
+    }
+
+    if (const auto it = element.find("trigger"); it != element.end())
+    {
+      ReadActionDBData(it.value(), asset.effects.at(EffectType::kTrigger), tables);
+    }
+
+    if (const auto it = element.find("discard"); it != element.end())
+    {
+      ReadActionDBData(it.value(), asset.effects.at(EffectType::kDiscard), tables);
+    }
+
+    if (const auto it = element.find("pasive"); it != element.end())
+    {
+      ReadActionDBData(it.value(), asset.effects.at(EffectType::kPasive), tables);
+    }
+
+    tables.assets.insert({asset.name, asset});
+  }
+}
+
+namespace
+{
+// Finds where the values of the top level object start and end. Only strings and nesting are tracked, the values
+// themselves are validated when their section is parsed
+class SectionScanner
+{
+public:
+  SectionScanner(const char* data, const size_t size, const std::string& path):
+    mData{data},
+    mSize{size},
+    mPath{path}
+  {}
+
+  std::unordered_map<std::string, std::pair<size_t, size_t>> Scan()
+  {
+    std::unordered_map<std::string, std::pair<size_t, size_t>> sections;
+    Expect('{');
+    if (Peek() == '}')
+      return sections;
+
+    while (true)
+    {
+      SkipWhitespace();
+      const size_t keyBegin = mPosition + 1;
+      SkipString();
+      std::string key{mData + keyBegin, mPosition - keyBegin - 1};
+      Expect(':');
+      SkipWhitespace();
+      const size_t valueBegin = mPosition;
+      SkipValue();
+      sections.insert_or_assign(std::move(key), std::make_pair(valueBegin, mPosition));
+
+      if (Peek() == '}')
+        return sections;
+      Expect(',');
+    }
+  }
+
+private:
+  void SkipWhitespace()
+  {
+    while (mPosition < mSize && std::isspace(static_cast<unsigned char>(mData[mPosition])))
+      ++mPosition;
+  }
+
+  char Peek()
+  {
+    SkipWhitespace();
+    if (mPosition == mSize)
+      throw std::runtime_error(fmt::format("Card file '{}' ends unexpectedly", mPath));
+    return mData[mPosition];
+  }
+
+  void Expect(const char c)
+  {
+    if (Peek() != c)
+      throw std::runtime_error(fmt::format("Card file '{}' expected '{}' at byte {}", mPath, c, mPosition));
+    ++mPosition;
+  }
+
+  void SkipString()
+  {
+    Expect('"');
+    while (mPosition < mSize && mData[mPosition] != '"')
+      mPosition += mData[mPosition] == '\\' ? 2 : 1;
+    if (mPosition >= mSize)
+      throw std::runtime_error(fmt::format("Card file '{}' has an unterminated string", mPath));
+    ++mPosition;
+  }
+
+  void SkipValue()
+  {
+    int depth = 0;
+    do
+    {
+      switch (Peek())
+      {
+        case '"': SkipString(); continue;
+        case '{':
+        case '[': ++depth; break;
+        case '}':
+        case ']': --depth; break;
+        case ',':
+          if (depth == 0)
+            return;
+          break;
+        default: break;
+      }
+      ++mPosition;
+    } while (depth > 0);
+
+    // Scalars (numbers, true, false, null) end at the next delimiter
+    while (mPosition < mSize && mData[mPosition] != ',' && mData[mPosition] != '}' && mData[mPosition] != ']'
+           && !std::isspace(static_cast<unsigned char>(mData[mPosition])))
+      ++mPosition;
+  }
+
+  const char* mData;
+  size_t mSize;
+  const std::string& mPath;
+  size_t mPosition{0};
+};
+} // namespace
+
+CardDBTables CardDBReader::ReadJson(const std::string& path)
+{
+  using json = nlohmann::json;
+  std::fstream cardsFile{path};
+  if (!cardsFile.is_open())
+    throw std::runtime_error(fmt::format("Can not open card file '{}'", path));
+
+  CardDBTables tables;
+  json cardsData = json::parse(cardsFile);
+  for (const auto& [key, val]: cardsData.items())
+  {
+    if (key == kInvestigatorsKey)
+    {
+      ReadInvestigatorsObject(val, tables);
+    }
+    else if (key == kAssetsKey)
+    {
+      ReadAssetObject(val, tables);
+    }
+  }
+  return tables;
+}
+
+CardDBReader::SectionIndex CardDBReader::IndexJson(const std::string& path)
+{
+  const MappedFile file{path};
+  SectionScanner scanner{reinterpret_cast<const char*>(file.Data()), file.Size(), path};
+  return SectionIndex{path, scanner.Scan()};
+}
+
+void CardDBReader::ReadSection(const SectionIndex& index, const CardSection section, CardDBTables& tables)
+{
+  const auto it = index.sections.find(GetSectionKey(section));
+  if (it == index.sections.end())
+    return;
+
+  const MappedFile file{index.path};
+  const auto [begin, end] = it->second;
+  if (end > file.Size())
+    throw std::runtime_error(fmt::format("Card file '{}' changed since it was indexed", index.path));
+
+  const auto* data = reinterpret_cast<const char*>(file.Data());
+  const auto value = nlohmann::json::parse(data + begin, data + end);
+  switch (section)
+  {
+    case CardSection::kInvestigators: ReadInvestigatorsObject(value, tables); break;
+    case CardSection::kAssets: ReadAssetObject(value, tables); break;
+    default: break;
+  }
+}
+
+const std::string& CardDBReader::GetSectionKey(const CardSection section)
+{
+  static const std::string kNoKey;
+  switch (section)
+  {
+    case CardSection::kInvestigators: return kInvestigatorsKey;
+    case CardSection::kAssets: return kAssetsKey;
+    default: return kNoKey;
+  }
+}
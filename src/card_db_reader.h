@@ -0,0 +1,32 @@
+#pragma once
+
+#include "card_db_data.h"
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+// Reads the hand made card file (data/cards.json)
+class CardDBReader
+{
+public:
+  static inline const std::string kInvestigatorsKey{"investigators"};
+  static inline const std::string kAssetsKey{"assets"};
+
+  static CardDBTables ReadJson(const std::string& path);
+
+  // Byte range of every top level section of a card file, found by scanning the file without parsing the cards
+  struct SectionIndex
+  {
+    std::string path;
+    std::unordered_map<std::string, std::pair<size_t, size_t>> sections;
+  };
+
+  static SectionIndex IndexJson(const std::string& path);
+
+  // Parses only one section of an indexed file into tables, nothing if the file does not have that section
+  static void ReadSection(const SectionIndex& index, CardSection section, CardDBTables& tables);
+
+  static const std::string& GetSectionKey(CardSection section);
+};
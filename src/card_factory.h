@@ -3,12 +3,13 @@
 #include "card_db.h"
 
 #include <memory>
+#include <string_view>
 
 class CardFactory
 {
 public:
   template<typename T>
-  static inline std::shared_ptr<T> CreateCard(const std::string& name)
+  static inline std::shared_ptr<const T> CreateCard(const std::string_view name)
   {
     return std::move(CardDB::Instance().GetCard<T>(name));
   }
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+// Index of a card inside the card table owned by CardDB
+using CardId = uint16_t;
+
+static inline constexpr CardId kInvalidCardId = UINT16_MAX;
+
+// One card in play, handed out by whoever puts it into play. Two copies of the same card are different cards in
+// play
+using CardInPlayId = uint32_t;
@@ -0,0 +1,343 @@
+#include "card_image.h"
+
+#include "mapped_file.h"
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <functional>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+
+static_assert(std::endian::native == std::endian::little, "CardImage is only implemented for little endian hosts");
+
+namespace
+{
+class ImageWriter
+{
+public:
+  CardImage::StringRecord AddString(const std::string_view value)
+  {
+    if (const auto it = mStringOffsets.find(value); it != mStringOffsets.end())
+      return {it->second, static_cast<uint32_t>(value.size())};
+
+    const auto offset = static_cast<uint32_t>(mStrings.size());
+    mStrings.insert(mStrings.end(), value.begin(), value.end());
+    mStringOffsets.try_emplace(std::string{value}, offset);
+    return {offset, static_cast<uint32_t>(value.size())};
+  }
+
+  static CardImage::SkillRecord AddSkill(const Skill& skill)
+  {
+    return {skill.willpower, skill.intellect, skill.combat, skill.agility, skill.wild};
+  }
+
+  void AddInvestigator(const InvestigatorCardDBData& investigator)
+  {
+    CardImage::InvestigatorRecord record{};
+    record.name = AddString(investigator.name);
+    record.faction = AddString(investigator.faction);
+    record.traits = AddString(investigator.traits);
+    record.subname = AddString(investigator.subname);
+    record.skill = AddSkill(investigator.skill);
+    record.health = investigator.health;
+    record.sanity = investigator.sanity;
+    mInvestigators.push_back(record);
+  }
+
+  void AddAsset(const AssetCardDBData& asset)
+  {
+    CardImage::AssetRecord record{};
+    record.name = AddString(asset.name);
+    record.faction = AddString(asset.faction);
+    record.traits = AddString(asset.traits);
+    record.hasSlot = asset.slot.has_value();
+    record.slot = AddString(asset.slot.value_or(""));
+    record.skill = AddSkill(asset.skill);
+    record.cost = asset.cost;
+    record.hasUses = asset.uses.has_value();
+    record.uses = asset.uses.value_or(0);
+    record.health = asset.health;
+    record.sanity = asset.sanity;
+    for (size_t type = 0; type < CardImage::kEffectTypes; ++type)
+    {
+      const auto& actions = asset.effects.at(static_cast<EffectType>(type));
+      record.firstAction[type] = static_cast<uint32_t>(mActions.size());
+      record.actionCount[type] = static_cast<uint32_t>(actions.size());
+      std::for_each(actions.begin(), actions.end(), [this](const auto& action) { AddAction(action); });
+    }
+    mAssets.push_back(record);
+  }
+
+  std::vector<std::byte> Finish() const
+  {
+    CardImage::Header header{};
+    header.magic = CardImage::kMagic;
+    header.version = CardImage::kVersion;
+    uint32_t offset = sizeof(CardImage::Header);
+    auto section = [&offset](const auto& records, uint32_t& count, uint32_t& sectionOffset)
+    {
+      count = static_cast<uint32_t>(records.size());
+      sectionOffset = offset;
+      offset += static_cast<uint32_t>(records.size() * sizeof(records.front()));
+    };
+    section(mInvestigators, header.investigatorCount, header.investigatorOffset);
+    section(mAssets, header.assetCount, header.assetOffset);
+    section(mActions, header.actionCount, header.actionOffset);
+    section(mModifications, header.modificationCount, header.modificationOffset);
+    header.stringsOffset = offset;
+    header.stringsSize = static_cast<uint32_t>(mStrings.size());
+    header.size = offset + header.stringsSize;
+
+    std::vector<std::byte> image(header.size);
+    auto copy = [&image](const uint32_t at, const void* data, const size_t size)
+    {
+      if (size != 0)
+        std::memcpy(image.data() + at, data, size);
+    };
+    copy(0, &header, sizeof(header));
+    copy(header.investigatorOffset, mInvestigators.data(), mInvestigators.size() * sizeof(mInvestigators.front()));
+    copy(header.assetOffset, mAssets.data(), mAssets.size() * sizeof(mAssets.front()));
+    copy(header.actionOffset, mActions.data(), mActions.size() * sizeof(mActions.front()));
+    copy(header.modificationOffset, mModifications.data(), mModifications.size() * sizeof(mModifications.front()));
+    copy(header.stringsOffset, mStrings.data(), mStrings.size());
+    return image;
+  }
+
+private:
+  void AddAction(const ActionDBData& action)
+  {
+    CardImage::ActionRecord record{};
+    record.hasExpend = action.expend.has_value();
+    record.expend = action.expend.value_or(0);
+    record.action = AddString(action.action);
+    record.skill = AddSkill(action.skill_effect.skill);
+    record.hasOptional = action.skill_effect.optional_effect.has_value();
+    const auto optional = action.skill_effect.optional_effect.value_or(
+      ActionDBData::SkillEffectsDBData::OptionalEffectDBData{});
+    record.optionalSkill = AddSkill(optional.skill);
+    record.what = AddString(optional.what);
+    record.condition = AddString(optional.condition);
+    record.target = AddString(action.target);
+
+    // Sorted so that the same data always produces the same image
+    const std::map<std::string_view, std::variant<int8_t, std::string_view>> modifications{
+      action.modifications.begin(), action.modifications.end()};
+    record.firstModification = static_cast<uint32_t>(mModifications.size());
+    record.modificationCount = static_cast<uint32_t>(modifications.size());
+    for (const auto& [key, value]: modifications)
+    {
+      CardImage::ModificationRecord modification{};
+      modification.key = AddString(key);
+      modification.isText = std::holds_alternative<std::string_view>(value);
+      modification.value = modification.isText ? 0 : std::get<int8_t>(value);
+      modification.text = AddString(modification.isText ? std::get<std::string_view>(value) : "");
+      mModifications.push_back(modification);
+    }
+    mActions.push_back(record);
+  }
+
+  std::vector<CardImage::InvestigatorRecord> mInvestigators;
+  std::vector<CardImage::AssetRecord> mAssets;
+  std::vector<CardImage::ActionRecord> mActions;
+  std::vector<CardImage::ModificationRecord> mModifications;
+  std::vector<char> mStrings;
+  // Transparent, so looking up a string_view does not build a std::string
+  struct StringHash
+  {
+    using is_transparent = void;
+
+    size_t operator()(const std::string_view value) const
+    {
+      return std::hash<std::string_view>{}(value);
+    }
+  };
+  std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> mStringOffsets;
+};
+
+class ImageReader
+{
+public:
+  explicit ImageReader(std::span<const std::byte> image): mImage{image}
+  {
+    if (mImage.size() < sizeof(CardImage::Header))
+      throw std::runtime_error("Card image is truncated");
+    std::memcpy(&mHeader, mImage.data(), sizeof(mHeader));
+    if (mHeader.magic != CardImage::kMagic)
+      throw std::runtime_error("Not a card image");
+    if (mHeader.version != CardImage::kVersion)
+      throw std::runtime_error(
+        fmt::format("Card image version {} does not match version {}", mHeader.version, CardImage::kVersion));
+    if (mHeader.size != mImage.size())
+      throw std::runtime_error("Card image is truncated");
+
+    CheckSection(mHeader.investigatorOffset, mHeader.investigatorCount, sizeof(CardImage::InvestigatorRecord));
+    CheckSection(mHeader.assetOffset, mHeader.assetCount, sizeof(CardImage::AssetRecord));
+    CheckSection(mHeader.actionOffset, mHeader.actionCount, sizeof(CardImage::ActionRecord));
+    CheckSection(mHeader.modificationOffset, mHeader.modificationCount, sizeof(CardImage::ModificationRecord));
+    CheckSection(mHeader.stringsOffset, mHeader.stringsSize, 1);
+  }
+
+  const CardImage::Header& GetHeader() const
+  {
+    return mHeader;
+  }
+
+  template<typename T>
+  T GetRecord(const uint32_t sectionOffset, const uint32_t sectionCount, const uint32_t index) const
+  {
+    if (index >= sectionCount)
+      throw std::runtime_error("Card image record out of range");
+    T record;
+    std::memcpy(&record, mImage.data() + sectionOffset + static_cast<size_t>(index) * sizeof(T), sizeof(T));
+    return record;
+  }
+
+  // Points into the string pool of the image, nothing is copied
+  std::string_view GetString(const CardImage::StringRecord& string) const
+  {
+    if (static_cast<uint64_t>(string.offset) + string.size > mHeader.stringsSize)
+      throw std::runtime_error("Card image string out of range");
+    return std::string_view{reinterpret_cast<const char*>(mImage.data()) + mHeader.stringsOffset + string.offset,
+                            string.size};
+  }
+
+  static Skill GetSkill(const CardImage::SkillRecord& skill)
+  {
+    return Skill{skill.willpower, skill.intellect, skill.combat, skill.agility, skill.wild};
+  }
+
+  ActionDBData GetAction(const uint32_t index) const
+  {
+    const auto record = GetRecord<CardImage::ActionRecord>(mHeader.actionOffset, mHeader.actionCount, index);
+    ActionDBData action;
+    if (record.hasExpend)
+      action.expend = record.expend;
+    action.action = GetString(record.action);
+    action.skill_effect.skill = GetSkill(record.skill);
+    if (record.hasOptional)
+    {
+      action.skill_effect.optional_effect = ActionDBData::SkillEffectsDBData::OptionalEffectDBData{
+        GetSkill(record.optionalSkill), GetString(record.what), GetString(record.condition)};
+    }
+    action.target = GetString(record.target);
+    for (uint32_t i = 0; i < record.modificationCount; ++i)
+    {
+      const auto modification = GetRecord<CardImage::ModificationRecord>(mHeader.modificationOffset,
+                                                                          mHeader.modificationCount,
+                                                                          record.firstModification + i);
+      if (modification.isText)
+        action.modifications.insert({GetString(modification.key), GetString(modification.text)});
+      else
+        action.modifications.insert({GetString(modification.key), modification.value});
+    }
+    return action;
+  }
+
+private:
+  void CheckSection(const uint32_t offset, const uint32_t count, const size_t recordSize) const
+  {
+    if (static_cast<uint64_t>(offset) + static_cast<uint64_t>(count) * recordSize > mImage.size())
+      throw std::runtime_error("Card image section out of range");
+  }
+
+  std::span<const std::byte> mImage;
+  CardImage::Header mHeader;
+};
+} // namespace
+
+std::vector<std::byte> CardImage::Write(const CardDBTables& tables)
+{
+  ImageWriter writer;
+
+  // Sorted by name so that the same data always produces the same image
+  const std::map<std::string_view, InvestigatorCardDBData> investigators{tables.investigators.begin(),
+                                                                         tables.investigators.end()};
+  const std::map<std::string_view, AssetCardDBData> assets{tables.assets.begin(), tables.assets.end()};
+  for (const auto& [_, investigator]: investigators)
+    writer.AddInvestigator(investigator);
+  for (const auto& [_, asset]: assets)
+    writer.AddAsset(asset);
+  return writer.Finish();
+}
+
+void CardImage::WriteFile(const CardDBTables& tables, const std::string& path)
+{
+  const auto image = Write(tables);
+  std::ofstream file{path, std::ios::binary | std::ios::trunc};
+  file.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+  if (!file)
+    throw std::runtime_error(fmt::format("Can not write card image '{}'", path));
+}
+
+CardDBTables CardImage::Read(std::span<const std::byte> image)
+{
+  CardDBTables tables;
+  Read(image, CardSection::kInvestigators, tables);
+  Read(image, CardSection::kAssets, tables);
+  return tables;
+}
+
+void CardImage::Read(std::span<const std::byte> image, const CardSection section, CardDBTables& tables)
+{
+  const ImageReader reader{image};
+  const auto& header = reader.GetHeader();
+
+  if (section == CardSection::kInvestigators)
+  {
+    for (uint32_t i = 0; i < header.investigatorCount; ++i)
+    {
+      const auto record =
+        reader.GetRecord<InvestigatorRecord>(header.investigatorOffset, header.investigatorCount, i);
+      InvestigatorCardDBData investigator;
+      investigator.name = reader.GetString(record.name);
+      investigator.faction = reader.GetString(record.faction);
+      investigator.traits = reader.GetString(record.traits);
+      investigator.subname = reader.GetString(record.subname);
+      investigator.skill = ImageReader::GetSkill(record.skill);
+      investigator.health = record.health;
+      investigator.sanity = record.sanity;
+      tables.investigators.insert({investigator.name, investigator});
+    }
+  }
+
+  if (section == CardSection::kAssets)
+  {
+    for (uint32_t i = 0; i < header.assetCount; ++i)
+    {
+      const auto record = reader.GetRecord<AssetRecord>(header.assetOffset, header.assetCount, i);
+      AssetCardDBData asset;
+      asset.name = reader.GetString(record.name);
+      asset.faction = reader.GetString(record.faction);
+      asset.traits = reader.GetString(record.traits);
+      if (record.hasSlot)
+        asset.slot = reader.GetString(record.slot);
+      asset.skill = ImageReader::GetSkill(record.skill);
+      asset.cost = record.cost;
+      if (record.hasUses)
+        asset.uses = record.uses;
+      asset.health = record.health;
+      asset.sanity = record.sanity;
+      for (size_t type = 0; type < kEffectTypes; ++type)
+      {
+        auto& actions = asset.effects.at(static_cast<EffectType>(type));
+        for (uint32_t action = 0; action < record.actionCount[type]; ++action)
+          actions.push_back(reader.GetAction(record.firstAction[type] + action));
+      }
+      tables.assets.insert({asset.name, asset});
+    }
+  }
+}
+
+CardDBTables CardImage::ReadFile(const std::string& path)
+{
+  auto file = std::make_shared<const MappedFile>(path);
+  auto tables = Read({file->Data(), file->Size()});
+  tables.storage = std::move(file);
+  return tables;
+}
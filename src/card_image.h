@@ -0,0 +1,128 @@
+#pragma once
+
+#include "card_db_data.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+// Versioned binary image of the card data, written at build time by ArkhamHorror_CardCompiler from
+// data/cards.json. Every record has a fixed size and refers to other records and to the string pool through
+// offsets from the start of the image, so the image is position independent and can be mapped and read in place.
+// Multi byte values are little endian.
+class CardImage
+{
+public:
+  static inline constexpr std::array<char, 4> kMagic = {'A', 'H', 'C', 'I'};
+  static inline constexpr uint32_t kVersion = 1;
+
+  struct StringRecord
+  {
+    uint32_t offset; // From the start of the string pool
+    uint32_t size;
+  };
+
+  struct SkillRecord
+  {
+    int8_t willpower;
+    int8_t intellect;
+    int8_t combat;
+    int8_t agility;
+    int8_t wild;
+  };
+
+  struct Header
+  {
+    std::array<char, 4> magic;
+    uint32_t version;
+    uint32_t size; // Whole image
+    uint32_t investigatorCount;
+    uint32_t investigatorOffset;
+    uint32_t assetCount;
+    uint32_t assetOffset;
+    uint32_t actionCount;
+    uint32_t actionOffset;
+    uint32_t modificationCount;
+    uint32_t modificationOffset;
+    uint32_t stringsOffset;
+    uint32_t stringsSize;
+  };
+
+  struct InvestigatorRecord
+  {
+    StringRecord name;
+    StringRecord faction;
+    StringRecord traits;
+    StringRecord subname;
+    SkillRecord skill;
+    uint8_t health;
+    uint8_t sanity;
+    uint8_t padding[1];
+  };
+
+  struct ModificationRecord
+  {
+    StringRecord key;
+    StringRecord text; // Only for text modifications (conditions)
+    uint8_t isText;
+    int8_t value;
+    uint8_t padding[2];
+  };
+
+  struct ActionRecord
+  {
+    StringRecord action;
+    StringRecord what;
+    StringRecord condition;
+    StringRecord target;
+    uint32_t firstModification;
+    uint32_t modificationCount;
+    SkillRecord skill;
+    SkillRecord optionalSkill;
+    uint8_t hasExpend;
+    uint8_t expend;
+    uint8_t hasOptional;
+    uint8_t padding[3];
+  };
+
+  // Effect lists are indexed by EffectType
+  static inline constexpr size_t kEffectTypes = static_cast<size_t>(EffectType::kInvalid);
+
+  struct AssetRecord
+  {
+    StringRecord name;
+    StringRecord faction;
+    StringRecord traits;
+    StringRecord slot;
+    std::array<uint32_t, kEffectTypes> firstAction;
+    std::array<uint32_t, kEffectTypes> actionCount;
+    SkillRecord skill;
+    uint8_t cost;
+    uint8_t hasSlot;
+    uint8_t hasUses;
+    uint8_t uses;
+    uint8_t health;
+    uint8_t sanity;
+    uint8_t padding[1];
+  };
+
+  static std::vector<std::byte> Write(const CardDBTables& tables);
+  static void WriteFile(const CardDBTables& tables, const std::string& path);
+
+  // Throws if the image is truncated, corrupted or from another version. The text of the tables points into the
+  // string pool of the image, which must outlive them
+  static CardDBTables Read(std::span<const std::byte> image);
+  // Reads only the records of one section into tables
+  static void Read(std::span<const std::byte> image, CardSection section, CardDBTables& tables);
+  // The tables keep the file mapped
+  static CardDBTables ReadFile(const std::string& path);
+};
+
+static_assert(sizeof(CardImage::Header) == 52);
+static_assert(sizeof(CardImage::InvestigatorRecord) == 40);
+static_assert(sizeof(CardImage::ModificationRecord) == 20);
+static_assert(sizeof(CardImage::ActionRecord) == 56);
+static_assert(sizeof(CardImage::AssetRecord) == 76);
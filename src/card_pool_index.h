@@ -0,0 +1,280 @@
+#pragma once
+
+#include "card_db_data.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// One bit per card of a pool, bit i is the card at position i
+class CardBitmap
+{
+public:
+  CardBitmap() = default;
+  explicit CardBitmap(const size_t size, const bool value = false):
+    mWords((size + kWordBits - 1) / kWordBits, value ? ~uint64_t{0} : 0),
+    mSize{size}
+  {
+    ClearPadding();
+  }
+
+  void Set(const size_t position)
+  {
+    mWords[position / kWordBits] |= uint64_t{1} << (position % kWordBits);
+  }
+
+  bool Test(const size_t position) const
+  {
+    return (mWords[position / kWordBits] >> (position % kWordBits)) & 1;
+  }
+
+  CardBitmap& operator&=(const CardBitmap& other)
+  {
+    for (size_t i = 0; i < mWords.size(); ++i)
+      mWords[i] &= other.mWords[i];
+    return *this;
+  }
+
+  CardBitmap& operator|=(const CardBitmap& other)
+  {
+    for (size_t i = 0; i < mWords.size(); ++i)
+      mWords[i] |= other.mWords[i];
+    return *this;
+  }
+
+  size_t Count() const
+  {
+    size_t count = 0;
+    for (const auto word: mWords)
+      count += std::popcount(word);
+    return count;
+  }
+
+  size_t Size() const
+  {
+    return mSize;
+  }
+
+  // Calls function with the position of every set bit, in increasing order
+  template<typename Function>
+  void ForEach(Function&& function) const
+  {
+    for (size_t i = 0; i < mWords.size(); ++i)
+    {
+      for (auto word = mWords[i]; word != 0; word &= word - 1)
+        function(i * kWordBits + std::countr_zero(word));
+    }
+  }
+
+  std::vector<size_t> ToPositions() const
+  {
+    std::vector<size_t> positions;
+    positions.reserve(Count());
+    ForEach([&positions](const size_t position) { positions.push_back(position); });
+    return positions;
+  }
+
+  bool operator==(const CardBitmap&) const = default;
+
+private:
+  static inline constexpr size_t kWordBits = 64;
+
+  void ClearPadding()
+  {
+    if (mSize % kWordBits != 0)
+      mWords.back() &= (uint64_t{1} << (mSize % kWordBits)) - 1;
+  }
+
+  std::vector<uint64_t> mWords;
+  size_t mSize{0};
+};
+
+enum class SkillIcon : uint8_t
+{
+  kWillpower,
+  kIntellect,
+  kCombat,
+  kAgility,
+  kWild,
+  kInvalid
+};
+
+// Per attribute bitmaps over a card pool, built once with the pool. A query starts from every card and intersects
+// one bitmap per condition, so it costs a few word operations per 64 cards whatever the condition
+class CardPoolIndex
+{
+  // Transparent, so a query looks up its string_view keys without building a std::string
+  struct KeyHash
+  {
+    using is_transparent = void;
+
+    size_t operator()(const std::string_view value) const
+    {
+      return std::hash<std::string_view>{}(value);
+    }
+  };
+  using Bitmaps = std::unordered_map<std::string, CardBitmap, KeyHash, std::equal_to<>>;
+
+public:
+  class Query
+  {
+  public:
+    explicit Query(const CardPoolIndex& index): mIndex{index}, mCards{index.mSize, true} {}
+
+    Query& WithFaction(const std::string_view faction)
+    {
+      return Intersect(mIndex.mFactions, faction);
+    }
+
+    Query& WithType(const std::string_view type)
+    {
+      return Intersect(mIndex.mTypes, type);
+    }
+
+    // Slot name without multiplier: "Hand" matches "Hand" and "Hand x2"
+    Query& WithSlot(const std::string_view slot)
+    {
+      return Intersect(mIndex.mSlots, slot);
+    }
+
+    // Chain it to require several traits
+    Query& WithTrait(const std::string_view trait)
+    {
+      return Intersect(mIndex.mTraits, trait);
+    }
+
+    // Cards with a fixed cost of at most cost, cards without a cost (X or none) never match
+    Query& WithCostAtMost(const int8_t cost)
+    {
+      if (cost < 0 || mIndex.mCostAtMost.empty())
+        mCards = CardBitmap{mIndex.mSize};
+      else
+        mCards &= mIndex.mCostAtMost[std::min<size_t>(cost, mIndex.mCostAtMost.size() - 1)];
+      return *this;
+    }
+
+    // Cards with at least one icon of that skill to commit to skill tests
+    Query& WithIcon(const SkillIcon icon)
+    {
+      mCards &= mIndex.mIcons.at(static_cast<size_t>(icon));
+      return *this;
+    }
+
+    const CardBitmap& GetCards() const
+    {
+      return mCards;
+    }
+
+  private:
+    Query& Intersect(const Bitmaps& bitmaps, const std::string_view key)
+    {
+      if (const auto it = bitmaps.find(key); it != bitmaps.end())
+        mCards &= it->second;
+      else
+        mCards = CardBitmap{mIndex.mSize};
+      return *this;
+    }
+
+    const CardPoolIndex& mIndex;
+    CardBitmap mCards;
+  };
+
+  CardPoolIndex() = default;
+
+  explicit CardPoolIndex(const std::vector<ArkhamDBCardData>& cards): mSize{cards.size()}
+  {
+    // One bucket per cost up to the highest of the pool, so no bucket mixes different costs
+    int8_t maxCost = -1;
+    for (const auto& card: cards)
+      maxCost = std::max(maxCost, card.cost.value_or(-1));
+    mCostAtMost.assign(static_cast<size_t>(maxCost + 1), CardBitmap{mSize});
+    mIcons.fill(CardBitmap{mSize});
+    for (size_t position = 0; position < cards.size(); ++position)
+      Add(position, cards[position]);
+
+    for (size_t cost = 1; cost < mCostAtMost.size(); ++cost)
+      mCostAtMost[cost] |= mCostAtMost[cost - 1];
+  }
+
+  Query Find() const
+  {
+    return Query{*this};
+  }
+
+  size_t Size() const
+  {
+    return mSize;
+  }
+
+private:
+  void Add(const size_t position, const ArkhamDBCardData& card)
+  {
+    SetIn(mFactions, card.faction_code, position);
+    SetIn(mTypes, card.type_code, position);
+    for (const auto& slot: Split(card.slot))
+    {
+      // "Hand x2" takes two hand slots, it is still a hand card
+      SetIn(mSlots, slot.substr(0, slot.find(" x")), position);
+    }
+    // Pool traits are keyed by name: the arkhamdb pool has more traits than a TraitMask holds
+    for (const auto& trait: Split(card.traits))
+      SetIn(mTraits, trait, position);
+
+    if (card.cost.has_value() && *card.cost >= 0)
+      mCostAtMost[static_cast<size_t>(*card.cost)].Set(position);
+
+    // The skill values of an investigator are its stats, not icons
+    if (card.type_code != "investigator")
+    {
+      const std::array<int8_t, static_cast<size_t>(SkillIcon::kInvalid)> icons = {
+        card.skill.willpower, card.skill.intellect, card.skill.combat, card.skill.agility, card.skill.wild};
+      for (size_t icon = 0; icon < icons.size(); ++icon)
+      {
+        if (icons[icon] > 0)
+          mIcons[icon].Set(position);
+      }
+    }
+  }
+
+  void SetIn(Bitmaps& bitmaps, const std::string_view key, const size_t position) const
+  {
+    if (key.empty())
+      return;
+    bitmaps.try_emplace(std::string{key}, mSize).first->second.Set(position);
+  }
+
+  // "Item. Weapon. Melee." gives Item, Weapon and Melee
+  static std::vector<std::string_view> Split(const std::string_view text)
+  {
+    std::vector<std::string_view> tokens;
+    size_t begin = 0;
+    while (begin < text.size())
+    {
+      const size_t end = std::min(text.find('.', begin), text.size());
+      auto token = text.substr(begin, end - begin);
+      while (!token.empty() && token.front() == ' ')
+        token.remove_prefix(1);
+      while (!token.empty() && token.back() == ' ')
+        token.remove_suffix(1);
+      if (!token.empty())
+        tokens.push_back(token);
+      begin = end + 1;
+    }
+    return tokens;
+  }
+
+  size_t mSize{0};
+  Bitmaps mFactions;
+  Bitmaps mTypes;
+  Bitmaps mSlots;
+  Bitmaps mTraits;
+  // mCostAtMost[c] holds every card costing c or less, the last one every card with a fixed cost
+  std::vector<CardBitmap> mCostAtMost;
+  std::array<CardBitmap, static_cast<size_t>(SkillIcon::kInvalid)> mIcons;
+};
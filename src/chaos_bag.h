@@ -1,8 +1,10 @@
 #pragma once
 
 #include "chaos_token.h"
+#include "random.h"
 
-#include <random>
+#include <algorithm>
+#include <stdexcept>
 #include <vector>
 
 class ChaosBag
@@ -13,29 +15,68 @@ public:
   virtual ChaosToken GetToken() = 0;
 };
 
+// Stores every distinct token once together with how many copies are in the bag. Draws pick a uniform slot of
+// a flat table of kind indices, so a draw is a single RNG call regardless of the bag size.
 class ChaosBagImpl: public ChaosBag
 {
 public:
-  ChaosBagImpl()
+  struct TokenCount
   {
-    std::random_device rd;
-    mGenerator = std::mt19937(rd());
+    ChaosToken token;
+    uint8_t count{0};
+  };
+
+  explicit ChaosBagImpl(const Philox4x32& generator): mGenerator{generator} {}
+
+  // Restarts the random sequence, copies of a bag share the sequence until one of them gets another generator
+  void SetGenerator(const Philox4x32& generator)
+  {
+    mGenerator = generator;
   }
 
   virtual void AddToken(const ChaosToken& token) override
   {
-    mTokens.push_back(token);
+    auto it = std::find_if(mTokenCounts.begin(),
+                           mTokenCounts.end(),
+                           [&token](const auto& tokenCount) { return tokenCount.token == token; });
+    // Counts and draw table entries are bytes, a bag past their range would disagree with GetTokenCounts
+    if (it == mTokenCounts.end())
+    {
+      if (mTokenCounts.size() > UINT8_MAX)
+        throw std::length_error("Chaos bag can not hold more token kinds");
+      mTokenCounts.push_back({token, 0});
+      it = std::prev(mTokenCounts.end());
+    }
+    if (it->count == UINT8_MAX)
+      throw std::length_error("Chaos bag can not hold more copies of a token");
+    ++it->count;
+
+    // Only the bag contents change the draw table, drawing never touches it
+    mDrawTable.push_back(static_cast<uint8_t>(std::distance(mTokenCounts.begin(), it)));
+    mDistribution = std::uniform_int_distribution<size_t>(0, mDrawTable.size() - 1);
   }
 
   virtual ChaosToken GetToken() override
   {
-    std::shuffle(mTokens.begin(), mTokens.end(), mGenerator);
-    std::uniform_int_distribution<size_t> dist(0, mTokens.size());
-    size_t r = dist(mGenerator);
-    return mTokens.at(r);
+    if (mDrawTable.empty())
+      throw std::runtime_error("Cannot draw a token from an empty chaos bag");
+
+    return mTokenCounts[mDrawTable[mDistribution(mGenerator)]].token;
+  }
+
+  const std::vector<TokenCount>& GetTokenCounts() const
+  {
+    return mTokenCounts;
+  }
+
+  size_t Size() const
+  {
+    return mDrawTable.size();
   }
 
 private:
-  std::vector<ChaosToken> mTokens;
-  std::mt19937 mGenerator;
-};
\ No newline at end of file
+  std::vector<TokenCount> mTokenCounts;
+  std::vector<uint8_t> mDrawTable; // One entry per token in the bag, indexes mTokenCounts
+  std::uniform_int_distribution<size_t> mDistribution;
+  Philox4x32 mGenerator;
+};
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <tuple>
+
 struct ChaosToken
 {
   enum class Token
@@ -18,4 +21,9 @@ struct ChaosToken
 
   Token token;
   int8_t effect;
-};
\ No newline at end of file
+};
+
+static inline bool operator==(const ChaosToken& lhs, const ChaosToken& rhs)
+{
+  return std::tie(lhs.token, lhs.effect) == std::tie(rhs.token, rhs.effect);
+}
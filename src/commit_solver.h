@@ -0,0 +1,190 @@
+#pragma once
+
+#include "skill_test_probability.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Cards of the hand to commit, as a bitmask over the hand
+struct CommitSet
+{
+  uint32_t cards{0};
+  uint32_t cost{0};
+  double success{0.0};
+  // False when no subset of the available cards reaches the target, cards is then every card that helps
+  bool reachesTarget{false};
+};
+
+// Finds the cheapest set of cards of a hand to commit to a SkillTest<T> so that it succeeds with at least the
+// target probability. The odds only depend on the number of icons commited, so they are computed once per icon
+// total from the chaos bag, and the set is a knapsack over icon totals capped at the first total that reaches
+// the target: O(cards * icons) per query. Queries are remembered by the bitmask of the cards still available
+template<typename T>
+class CommitSolver
+{
+public:
+  static inline constexpr size_t kMaxHandSize = 32;
+  static inline constexpr uint32_t kWholeHand = std::numeric_limits<uint32_t>::max();
+
+  // Without costs every card costs one, the solver commits as few cards as it can
+  template<typename Cards = std::vector<std::shared_ptr<Card>>>
+  CommitSolver(const Skill& skillTested,
+               const Player& player,
+               const ChaosBagImpl& chaosBag,
+               const Cards& hand,
+               const double targetSuccess,
+               std::vector<uint32_t> costs = {}):
+    mTargetSuccess{targetSuccess},
+    mCosts{std::move(costs)}
+  {
+    static_assert(!std::is_same_v<typename Cards::value_type, CardId>, "A hand of card ids needs its snapshot");
+    Build(skillTested, player, chaosBag, hand);
+  }
+
+  // Hand of card ids, resolved from the snapshot of the game that holds them
+  template<typename Cards = std::vector<CardId>>
+  CommitSolver(const Skill& skillTested,
+               const Player& player,
+               const ChaosBagImpl& chaosBag,
+               const Cards& hand,
+               const CardDB::Snapshot& snapshot,
+               const double targetSuccess,
+               std::vector<uint32_t> costs = {}):
+    mTargetSuccess{targetSuccess},
+    mCosts{std::move(costs)}
+  {
+    Build(skillTested, player, chaosBag, hand, snapshot);
+  }
+
+  CommitSet Solve(uint32_t available = kWholeHand)
+  {
+    available &= GetHandMask();
+    if (const auto it = mSolved.find(available); it != mSolved.end())
+      return it->second;
+    return mSolved.insert({available, Compute(available)}).first->second;
+  }
+
+  // Odds of the test with this many icons commited
+  double GetSuccess(const size_t icons) const
+  {
+    return mSuccessByIcons[std::min(icons, mSuccessByIcons.size() - 1)];
+  }
+
+private:
+  // Snapshot is empty when the hand holds cards rather than ids
+  template<typename Cards, typename... Snapshot>
+  void Build(const Skill& skillTested,
+             const Player& player,
+             const ChaosBagImpl& chaosBag,
+             const Cards& hand,
+             const Snapshot&... snapshot)
+  {
+    if (hand.size() > kMaxHandSize)
+      throw std::runtime_error(fmt::format("Can not solve the commits of a hand of {} cards", hand.size()));
+    if (mCosts.empty())
+      mCosts.assign(hand.size(), 1);
+    if (mCosts.size() != hand.size())
+      throw std::runtime_error(fmt::format("{} costs given for a hand of {} cards", mCosts.size(), hand.size()));
+
+    size_t totalIcons = 0;
+    for (const auto& card: hand)
+    {
+      // Negative icons never help, those cards are simply not commited
+      const auto icons = std::max<int8_t>(SkillTest<T>::GetCardValue(card, snapshot...), 0);
+      mIcons.push_back(static_cast<uint8_t>(icons));
+      totalIcons += icons;
+    }
+
+    const auto skillValue = SkillTest<T>::GetSkillValue(player, Cards{}, snapshot...);
+    const auto difficulty = SkillTest<T>::GetDifficulty(skillTested);
+    const auto& tokenCounts = chaosBag.GetTokenCounts();
+    const auto& tokens = player.GetTokenTable();
+    for (size_t icons = 0; icons <= totalIcons; ++icons)
+    {
+      const auto value = static_cast<int8_t>(skillValue + icons);
+      mSuccessByIcons.push_back(SkillTestProbability<T>::Get(value, difficulty, tokenCounts, tokens).success);
+    }
+  }
+
+  struct Entry
+  {
+    uint32_t cost{std::numeric_limits<uint32_t>::max()};
+    uint32_t cards{0};
+  };
+
+  uint32_t GetHandMask() const
+  {
+    return mIcons.size() == kMaxHandSize ? kWholeHand : (1u << mIcons.size()) - 1;
+  }
+
+  size_t GetIcons(const uint32_t cards) const
+  {
+    size_t icons = 0;
+    for (size_t i = 0; i < mIcons.size(); ++i)
+    {
+      if (cards & (1u << i))
+        icons += mIcons[i];
+    }
+    return icons;
+  }
+
+  CommitSet Compute(const uint32_t available) const
+  {
+    // Icons needed to reach the target, if any amount the hand can give does
+    const auto reaching =
+      std::find_if(mSuccessByIcons.begin(), mSuccessByIcons.end(), [this](const double success) {
+        return success >= mTargetSuccess;
+      });
+    const auto needed = static_cast<size_t>(std::distance(mSuccessByIcons.begin(), reaching));
+    if (reaching == mSuccessByIcons.end() || needed > GetIcons(available))
+    {
+      // Out of reach, everything that adds icons gets the odds as close as they go
+      CommitSet best;
+      for (size_t i = 0; i < mIcons.size(); ++i)
+      {
+        if ((available & (1u << i)) && mIcons[i] > 0)
+        {
+          best.cards |= 1u << i;
+          best.cost += mCosts[i];
+        }
+      }
+      best.success = GetSuccess(GetIcons(best.cards));
+      return best;
+    }
+
+    // best[icons] is the cheapest set found with that many icons, the last entry holds every set reaching needed
+    std::vector<Entry> best(needed + 1);
+    best[0].cost = 0;
+    for (size_t i = 0; i < mIcons.size(); ++i)
+    {
+      if (!(available & (1u << i)) || mIcons[i] == 0)
+        continue;
+
+      // Downwards so that each card is used at most once
+      for (size_t icons = needed + 1; icons-- > 0;)
+      {
+        if (best[icons].cost == std::numeric_limits<uint32_t>::max())
+          continue;
+
+        auto& next = best[std::min(needed, icons + mIcons[i])];
+        const auto cost = best[icons].cost + mCosts[i];
+        if (cost < next.cost)
+          next = {cost, best[icons].cards | (1u << i)};
+      }
+    }
+
+    const auto& solution = best[needed];
+    return {solution.cards, solution.cost, GetSuccess(GetIcons(solution.cards)), true};
+  }
+
+  double mTargetSuccess;
+  std::vector<uint32_t> mCosts;
+  std::vector<uint8_t> mIcons;
+  std::vector<double> mSuccessByIcons;
+  std::unordered_map<uint32_t, CommitSet> mSolved;
+};
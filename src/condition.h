@@ -1,7 +1,17 @@
 #pragma once
 
+#include <variant>
+
 class Condition
 {};
 
 class OnlyEnemyEngaged: public Condition
-{};
\ No newline at end of file
+{};
+
+static inline bool operator==(const OnlyEnemyEngaged&, const OnlyEnemyEngaged&)
+{
+  return true;
+}
+
+// Condition of an effect, held by value. std::monostate is an effect without condition
+using ConditionVariant = std::variant<std::monostate, OnlyEnemyEngaged>;
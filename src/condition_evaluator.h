@@ -0,0 +1,134 @@
+#pragma once
+
+#include "card_id.h"
+#include "condition.h"
+#include "effect.h"
+
+#include <cstdint>
+#include <limits>
+
+// Game state the effect conditions depend on. Each part has an epoch that changes whenever that part changes, so
+// an evaluation stays valid for as long as the epochs it read, the investigator taking the action and, for the
+// conditions on its location, the location it is at do not change.
+// Standalone for now: Game does not track locations, clues or enemies yet. The code that adds them implements
+// this interface and bumps its ConditionEpochs wherever engagement or clues change
+class ConditionState
+{
+public:
+  virtual ~ConditionState() = default;
+  // Investigator card in play taking the action, the conditions below are read for it
+  virtual CardInPlayId GetActingInvestigator() const = 0;
+  // Location card in play where the investigator taking the action is
+  virtual CardInPlayId GetActingLocation() const = 0;
+  // Whether an enemy is engaged with the investigator taking the action
+  virtual bool IsEnemyEngaged() const = 0;
+  // Clues left at the location of the investigator taking the action
+  virtual uint8_t GetUndiscoveredClues() const = 0;
+  virtual uint64_t GetEngagementEpoch() const = 0;
+  virtual uint64_t GetCluesEpoch() const = 0;
+};
+
+// Epoch counters for a ConditionState implementation, bumped by the code that changes the state. Moving an
+// investigator bumps neither: the location is part of the cached key instead
+struct ConditionEpochs
+{
+  void EngagementChanged()
+  {
+    ++engagement;
+  }
+
+  void CluesChanged()
+  {
+    ++clues;
+  }
+
+  uint64_t engagement{0};
+  uint64_t clues{0};
+};
+
+// Evaluates effect conditions against a ConditionState and remembers each result until the epoch it depends on,
+// the acting investigator or, for the conditions on its location, its location changes. Scoring many candidate
+// actions against the same state reads the state once per condition
+class ConditionEvaluator
+{
+public:
+  explicit ConditionEvaluator(const ConditionState& state): mState{state} {}
+
+  bool Evaluate(const ConditionVariant& condition)
+  {
+    struct Visitor
+    {
+      bool operator()(const std::monostate) const
+      {
+        return true;
+      }
+      bool operator()(const OnlyEnemyEngaged&) const
+      {
+        return evaluator.IsEnemyEngaged();
+      }
+      ConditionEvaluator& evaluator;
+    };
+    return std::visit(Visitor{*this}, condition);
+  }
+
+  bool Evaluate(const LocationOptionalEffectCondition condition)
+  {
+    switch (condition)
+    {
+      case LocationOptionalEffectCondition::kUndiscoveredClues: return HasUndiscoveredClues();
+      default: return false;
+    }
+  }
+
+  // Whether the additional damage of the effect applies
+  bool Evaluate(const FightEffectWithAdditionalDamageWithCondition& effect)
+  {
+    return Evaluate(effect.GetCondition());
+  }
+
+  // Whether the optional skill of the effect applies
+  bool Evaluate(const LocationOptionalFightEffectWithAdditionalDamage& effect)
+  {
+    return Evaluate(effect.GetLocationOptionalEffect().GetCondition());
+  }
+
+private:
+  struct CachedResult
+  {
+    uint64_t epoch{std::numeric_limits<uint64_t>::max()};
+    CardInPlayId investigator{0};
+    CardInPlayId location{0};
+    bool value{false};
+  };
+
+  // Location of the results that do not depend on where the investigator is
+  static inline constexpr CardInPlayId kAnyLocation = 0;
+
+  template<typename Compute>
+  bool GetCached(CachedResult& cached, const uint64_t epoch, const CardInPlayId location, Compute&& compute) const
+  {
+    const auto investigator = mState.GetActingInvestigator();
+    if (cached.epoch != epoch || cached.investigator != investigator || cached.location != location)
+      cached = {epoch, investigator, location, compute()};
+    return cached.value;
+  }
+
+  // Engaged enemies follow the investigator when it moves
+  bool IsEnemyEngaged()
+  {
+    return GetCached(
+      mEnemyEngaged, mState.GetEngagementEpoch(), kAnyLocation, [this]() { return mState.IsEnemyEngaged(); });
+  }
+
+  // Moving does not change the clues of any location, so the clue epoch stays and the location is part of the key
+  bool HasUndiscoveredClues()
+  {
+    return GetCached(mUndiscoveredClues, mState.GetCluesEpoch(), mState.GetActingLocation(), [this]() {
+      return mState.GetUndiscoveredClues() > 0;
+    });
+  }
+
+  const ConditionState& mState;
+  CachedResult mEnemyEngaged;
+  CachedResult mUndiscoveredClues;
+};
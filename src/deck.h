@@ -1,19 +1,18 @@
 #pragma once
 #include "card.h"
+#include "card_id.h"
+#include "random.h"
+#include "ring_buffer.h"
 
 #include <algorithm>
 #include <memory>
 #include <queue>
-#include <random>
+#include <stdexcept>
 
 class DeckShuffler
 {
 public:
-  DeckShuffler()
-  {
-    std::random_device rd;
-    mGen = std::mt19937(rd());
-  }
+  explicit DeckShuffler(const Philox4x32& generator): mGen{generator} {}
 
   template<typename T>
   void operator()(T& theCards)
@@ -36,28 +35,40 @@ public:
   }
 
 private:
-  std::mt19937 mGen;
+  Philox4x32 mGen;
 };
 
+// T is the container holding the cards, its value_type is what gets added and drawn: either the cards themselves
+// (std::shared_ptr<Card>) or their CardId in the CardDB card table
 template<typename T>
 class Deck
 {
 public:
+  using CardType = typename T::value_type;
+
   virtual ~Deck() = default;
-  virtual void AddCard(std::shared_ptr<Card> card) = 0;
+  virtual void AddCard(CardType card) = 0;
   virtual bool Empty() const = 0;
   virtual size_t Size() const = 0;
   virtual void Shuffle() = 0;
-  virtual std::shared_ptr<Card> DrawCard() = 0;
+  virtual CardType DrawCard() = 0;
 };
 
 template<typename T>
 class DeckImpl: public Deck<T>
 {
 public:
-  DeckImpl() {}
+  using typename Deck<T>::CardType;
+
+  explicit DeckImpl(const Philox4x32& generator): mShuffler{generator} {}
+
+  // Later shuffles draw from another stream, the cards stay where they are
+  void SetGenerator(const Philox4x32& generator)
+  {
+    mShuffler = DeckShuffler{generator};
+  }
 
-  virtual void AddCard(std::shared_ptr<Card> card) override;
+  virtual void AddCard(CardType card) override;
 
   virtual bool Empty() const override
   {
@@ -71,27 +82,39 @@ public:
 
   virtual void Shuffle() override
   {
-    static DeckShuffler deckShuffler;
-    deckShuffler.operator()<T>(mCards);
+    mShuffler.operator()<T>(mCards);
   }
 
-  virtual std::shared_ptr<Card> DrawCard() override;
+  virtual CardType DrawCard() override;
+
+  const T& GetCards() const
+  {
+    return mCards;
+  }
 
 private:
   T mCards;
+  DeckShuffler mShuffler;
 };
 
 template<typename T>
-inline void DeckImpl<T>::AddCard(std::shared_ptr<Card> card)
+inline void DeckImpl<T>::AddCard(CardType card)
 {
   mCards.push_back(std::move(card));
 }
 
 template<typename T>
-inline std::shared_ptr<Card> DeckImpl<T>::DrawCard()
+inline typename DeckImpl<T>::CardType DeckImpl<T>::DrawCard()
 {
-  auto card = mCards.front();
-  mCards.erase(mCards.begin());
+  if (mCards.empty())
+    throw std::runtime_error("Cannot draw a card from an empty deck");
+
+  auto card = std::move(mCards.front());
+  // Containers with a constant time pop_front (RingBuffer) avoid shifting the whole deck
+  if constexpr (requires(T & cards) { cards.pop_front(); })
+    mCards.pop_front();
+  else
+    mCards.erase(mCards.begin());
   return card;
 }
 
@@ -104,6 +127,9 @@ inline void DeckImpl<std::queue<std::shared_ptr<Card>>>::AddCard(std::shared_ptr
 template<>
 inline std::shared_ptr<Card> DeckImpl<std::queue<std::shared_ptr<Card>>>::DrawCard()
 {
+  if (mCards.empty())
+    throw std::runtime_error("Cannot draw a card from an empty deck");
+
   auto card = mCards.front();
   mCards.pop();
   return card;
@@ -2,9 +2,12 @@
 
 #include "condition.h"
 #include "skill.h"
+#include "small_vector.h"
 #include "spdlog/spdlog.h"
 
+#include <array>
 #include <tuple>
+#include <variant>
 
 enum class EffectType
 {
@@ -15,13 +18,46 @@ enum class EffectType
   kInvalid
 };
 
+inline constexpr size_t kEffectTypeCount = static_cast<size_t>(EffectType::kInvalid);
+
+// One list per EffectType, indexed by the type. at() throws for kInvalid like the map it replaces did for a
+// missing key
+template<typename List>
+class EffectTable
+{
+public:
+  List& operator[](const EffectType type)
+  {
+    return mLists[static_cast<size_t>(type)];
+  }
+
+  const List& operator[](const EffectType type) const
+  {
+    return mLists[static_cast<size_t>(type)];
+  }
+
+  List& at(const EffectType type)
+  {
+    return mLists.at(static_cast<size_t>(type));
+  }
+
+  const List& at(const EffectType type) const
+  {
+    return mLists.at(static_cast<size_t>(type));
+  }
+
+  friend bool operator==(const EffectTable& lhs, const EffectTable& rhs) = default;
+
+private:
+  std::array<List, kEffectTypeCount> mLists;
+};
+
 // Base class for all Effects
 class Effect
 {
 public:
   Effect() noexcept = default;
   Effect(const Skill& skill, const uint8_t activationCost): mSkill{skill}, mActivationCost{activationCost} {}
-  virtual ~Effect() = default;
 
   const Skill& GetSkill() const
   {
@@ -62,13 +98,13 @@ class EffectWithCondition: public Effect
 {
 public:
   EffectWithCondition() noexcept = default;
-  EffectWithCondition(const Skill& skill, const uint8_t activationCost, std::shared_ptr<Condition> condition):
+  EffectWithCondition(const Skill& skill, const uint8_t activationCost, const ConditionVariant& condition):
     Effect{skill, activationCost},
     mCondition{condition}
   {}
 
 protected:
-  std::shared_ptr<Condition> mCondition;
+  ConditionVariant mCondition;
   friend bool operator==(const EffectWithCondition& rhs, const EffectWithCondition& lhs);
 };
 
@@ -260,23 +296,28 @@ public:
   FightEffectWithAdditionalDamageWithCondition(const Skill& skill,
                                                const uint8_t activationCost,
                                                const uint8_t additionalDamage,
-                                               const std::shared_ptr<Condition> condition):
+                                               const ConditionVariant& condition):
     FightEffectWithAdditionalDamage{skill, activationCost, additionalDamage},
     mCondition{condition}
   {}
 
+  const ConditionVariant& GetCondition() const
+  {
+    return mCondition;
+  }
+
   friend bool operator==(const FightEffectWithAdditionalDamageWithCondition& rhs,
                          const FightEffectWithAdditionalDamageWithCondition& lhs);
 
 protected:
-  std::shared_ptr<Condition> mCondition;
+  ConditionVariant mCondition;
 };
 
 static inline bool operator==(const FightEffectWithAdditionalDamageWithCondition& lhs,
                               const FightEffectWithAdditionalDamageWithCondition& rhs)
 {
-  return std::tie(lhs.mSkill, lhs.mActivationCost, lhs.mAdditionalDamage)
-         == std::tie(rhs.mSkill, rhs.mActivationCost, rhs.mAdditionalDamage);
+  return std::tie(lhs.mSkill, lhs.mActivationCost, lhs.mAdditionalDamage, lhs.mCondition)
+         == std::tie(rhs.mSkill, rhs.mActivationCost, rhs.mAdditionalDamage, rhs.mCondition);
 }
 
 class MakeDamageToAttacker: public Effect
@@ -303,3 +344,31 @@ static inline bool operator==(const MakeDamageToAttacker& lhs, const MakeDamageT
   return std::tie(lhs.mSkill, lhs.mActivationCost, lhs.mAmount)
          == std::tie(rhs.mSkill, rhs.mActivationCost, rhs.mAmount);
 }
+
+// Every effect a card can have, held by value. Cards keep their effects in contiguous vectors of these and
+// std::visit picks the alternative, equality compares the alternative and all of its fields
+using EffectVariant = std::variant<Effect,
+                                   FightEffectWithAdditionalDamage,
+                                   FightEffectWithAdditionalDamageWithCondition,
+                                   LocationOptionalFightEffectWithAdditionalDamage,
+                                   InvestigateEffectWithShroudModification,
+                                   MakeDamageAtTargetAtCurrentLocation,
+                                   MakeDamageToAttacker>;
+
+// Most cards have at most one effect of each type, which stays inside the card
+using EffectList = SmallVector<EffectVariant, 1>;
+
+template<>
+struct fmt::formatter<EffectVariant>: fmt::formatter<std::string>
+{
+  auto format(const EffectVariant& effect, format_context& ctx) const -> decltype(ctx.out())
+  {
+    return std::visit([&ctx](const Effect& alternative) { return fmt::format_to(ctx.out(), "{}", alternative); },
+                      effect);
+  }
+};
+
+inline void PrintTo(const EffectVariant& effect, std::ostream* os)
+{
+  *os << fmt::format("{}", effect);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "condition.h"
+#include "effect.h"
+#include "skill.h"
+
+#include <stdexcept>
+#include <tuple>
+
+// Effect classes an EffectSpec builds
+enum class EffectKind : uint8_t
+{
+  kSkillTest,
+  kFightWithAdditionalDamage,
+  kFightWithAdditionalDamageWithCondition,
+  kLocationOptionalFight,
+  kInvestigateWithShroudModification,
+  kMakeDamageAtTargetAtCurrentLocation,
+  kMakeDamageToAttacker,
+  kInvalid
+};
+
+enum class EffectCondition : uint8_t
+{
+  kNone,
+  kOnlyEnemyEngaged,
+  kInvalid
+};
+
+// Card effect as it is compiled from the card data when the cards are loaded. Everything the effect needs is
+// already resolved, so building the effect does not look at the card data again
+struct EffectSpec
+{
+  EffectKind kind{EffectKind::kInvalid};
+  Skill skill;
+  Skill optionalSkill;
+  uint8_t activationCost{0};
+  int8_t amount{0}; // Damage, or shroud modification for investigations
+  LocationOptionalEffectCondition locationCondition{LocationOptionalEffectCondition::kInvalid};
+  EffectCondition condition{EffectCondition::kNone};
+};
+
+static inline bool operator==(const EffectSpec& lhs, const EffectSpec& rhs)
+{
+  return std::tie(lhs.kind,
+                  lhs.skill,
+                  lhs.optionalSkill,
+                  lhs.activationCost,
+                  lhs.amount,
+                  lhs.locationCondition,
+                  lhs.condition)
+         == std::tie(rhs.kind,
+                     rhs.skill,
+                     rhs.optionalSkill,
+                     rhs.activationCost,
+                     rhs.amount,
+                     rhs.locationCondition,
+                     rhs.condition);
+}
+
+static inline ConditionVariant MakeCondition(const EffectCondition condition)
+{
+  switch (condition)
+  {
+    case EffectCondition::kOnlyEnemyEngaged: return OnlyEnemyEngaged{};
+    default: return std::monostate{};
+  }
+}
+
+static inline EffectVariant MakeEffect(const EffectSpec& spec)
+{
+  const auto damage = static_cast<uint8_t>(spec.amount);
+  switch (spec.kind)
+  {
+    case EffectKind::kSkillTest: return Effect{spec.skill, spec.activationCost};
+    case EffectKind::kFightWithAdditionalDamage:
+      return FightEffectWithAdditionalDamage{spec.skill, spec.activationCost, damage};
+    case EffectKind::kFightWithAdditionalDamageWithCondition:
+      return FightEffectWithAdditionalDamageWithCondition{
+        spec.skill, spec.activationCost, damage, MakeCondition(spec.condition)};
+    case EffectKind::kLocationOptionalFight:
+      return LocationOptionalFightEffectWithAdditionalDamage{
+        spec.skill,
+        spec.activationCost,
+        damage,
+        LocationOptionalEffect{spec.skill, spec.activationCost, spec.optionalSkill, spec.locationCondition}};
+    case EffectKind::kInvestigateWithShroudModification:
+      return InvestigateEffectWithShroudModification{spec.skill, spec.activationCost, spec.amount};
+    case EffectKind::kMakeDamageAtTargetAtCurrentLocation:
+      return MakeDamageAtTargetAtCurrentLocation{spec.skill, spec.activationCost, damage};
+    case EffectKind::kMakeDamageToAttacker: return MakeDamageToAttacker{spec.skill, spec.activationCost, damage};
+    default:
+      throw std::runtime_error(
+        fmt::format("Effect spec of kind {} builds no effect", static_cast<int>(spec.kind)));
+  }
+}
@@ -0,0 +1,314 @@
+#include "embedded_cards.h"
+
+#include "card_db.h"
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+// String literal with every byte that is not plain printable ascii escaped in octal, which never runs into the
+// next character the way hexadecimal escapes do
+std::string Quote(const std::string_view value)
+{
+  std::string quoted{"\""};
+  for (const char c: value)
+  {
+    const auto byte = static_cast<uint8_t>(c);
+    if (c == '"' || c == '\\')
+      quoted += fmt::format("\\{}", c);
+    else if (byte < 0x20 || byte >= 0x7f)
+      quoted += fmt::format("\\{:03o}", byte);
+    else
+      quoted += c;
+  }
+  return quoted + '"';
+}
+
+std::string FormatSkill(const Skill& skill)
+{
+  return fmt::format(
+    "{{{}, {}, {}, {}, {}}}", skill.willpower, skill.intellect, skill.combat, skill.agility, skill.wild);
+}
+
+std::string FormatList(const std::vector<size_t>& values)
+{
+  std::string list;
+  for (const auto value: values)
+    list += fmt::format("{}{}", list.empty() ? "" : ", ", value);
+  return fmt::format("{{{}}}", list);
+}
+
+std::string FormatArray(const std::string_view name,
+                        const std::string_view type,
+                        const std::vector<std::string>& rows)
+{
+  std::string source =
+    fmt::format("inline constexpr std::array<EmbeddedCards::{}, {}> {}{{{{\n", type, rows.size(), name);
+  for (const auto& row: rows)
+    source += fmt::format("  {},\n", row);
+  return source + "}};\n\n";
+}
+
+class HeaderWriter
+{
+public:
+  void AddInvestigator(const InvestigatorCardDBData& investigator)
+  {
+    mInvestigators.push_back(fmt::format("{{{}, {}, {}, {}, {}, {}, {}}}",
+                                         Quote(investigator.name),
+                                         Quote(investigator.faction),
+                                         Quote(investigator.traits),
+                                         Quote(investigator.subname),
+                                         FormatSkill(investigator.skill),
+                                         investigator.health,
+                                         investigator.sanity));
+  }
+
+  void AddAsset(const AssetCardDBData& asset)
+  {
+    std::vector<size_t> firstAction;
+    std::vector<size_t> actionCount;
+    std::vector<size_t> firstEffectSpec;
+    std::vector<size_t> effectSpecCount;
+    for (size_t type = 0; type < EmbeddedCards::kEffectTypes; ++type)
+    {
+      const auto& actions = asset.effects.at(static_cast<EffectType>(type));
+      firstAction.push_back(mActions.size());
+      actionCount.push_back(actions.size());
+      firstEffectSpec.push_back(mEffectSpecs.size());
+      std::for_each(actions.begin(), actions.end(), [this](const auto& action) { AddAction(action); });
+      effectSpecCount.push_back(mEffectSpecs.size() - firstEffectSpec.back());
+    }
+    mAssets.push_back(fmt::format("{{{}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}}}",
+                                  Quote(asset.name),
+                                  Quote(asset.faction),
+                                  Quote(asset.traits),
+                                  Quote(asset.slot.value_or("")),
+                                  FormatList(firstAction),
+                                  FormatList(actionCount),
+                                  FormatList(firstEffectSpec),
+                                  FormatList(effectSpecCount),
+                                  FormatSkill(asset.skill),
+                                  asset.cost,
+                                  asset.slot.has_value(),
+                                  asset.uses.has_value(),
+                                  asset.uses.value_or(0),
+                                  asset.health,
+                                  asset.sanity));
+  }
+
+  std::string Finish() const
+  {
+    std::string source = "// Generated by ArkhamHorror_CardCompiler --cpp from the card data, do not edit\n"
+                         "#pragma once\n\n"
+                         "#include \"embedded_cards.h\"\n\n"
+                         "#include <stdexcept>\n\n"
+                         "namespace EmbeddedCardData\n{\n";
+    source += FormatArray("kInvestigators", "InvestigatorRecord", mInvestigators);
+    source += FormatArray("kAssets", "AssetRecord", mAssets);
+    source += FormatArray("kActions", "ActionRecord", mActions);
+    source += FormatArray("kModifications", "ModificationRecord", mModifications);
+    source += FormatArray("kEffectSpecs", "EffectSpecRecord", mEffectSpecs);
+    source += "inline constexpr EmbeddedCards::Tables kTables{\n"
+              "  kInvestigators, kAssets, kActions, kModifications, kEffectSpecs};\n\n"
+              "// CardId of an embedded card resolved at compile time, an unknown name does not compile\n"
+              "consteval CardId GetAssetId(const std::string_view name)\n"
+              "{\n"
+              "  const auto id = EmbeddedCards::FindAssetId(kAssets, name);\n"
+              "  if (id == kInvalidCardId)\n"
+              "    throw std::invalid_argument(\"Unknown card\");\n"
+              "  return id;\n"
+              "}\n"
+              "} // namespace EmbeddedCardData\n";
+    return source;
+  }
+
+private:
+  void AddAction(const ActionDBData& action)
+  {
+    const auto optional = action.skill_effect.optional_effect.value_or(
+      ActionDBData::SkillEffectsDBData::OptionalEffectDBData{});
+
+    // Sorted so that the same data always produces the same header
+    const std::map<std::string_view, std::variant<int8_t, std::string_view>> modifications{
+      action.modifications.begin(), action.modifications.end()};
+    const size_t firstModification = mModifications.size();
+    for (const auto& [key, value]: modifications)
+    {
+      const bool isText = std::holds_alternative<std::string_view>(value);
+      mModifications.push_back(fmt::format("{{{}, {}, {}, {}}}",
+                                           Quote(key),
+                                           Quote(isText ? std::get<std::string_view>(value) : ""),
+                                           isText,
+                                           isText ? 0 : std::get<int8_t>(value)));
+    }
+
+    mActions.push_back(fmt::format("{{{}, {}, {}, {}, {}, {}, {}, {}, {}, {}, {}}}",
+                                   Quote(action.action),
+                                   Quote(optional.what),
+                                   Quote(optional.condition),
+                                   Quote(action.target),
+                                   firstModification,
+                                   modifications.size(),
+                                   FormatSkill(action.skill_effect.skill),
+                                   FormatSkill(optional.skill),
+                                   action.expend.has_value(),
+                                   action.expend.value_or(0),
+                                   action.skill_effect.optional_effect.has_value()));
+
+    // Compiled here rather than when the cards load, an action that builds no effect has no spec
+    if (const auto spec = CardDB::CompileEffect(action); spec.has_value())
+    {
+      mEffectSpecs.push_back(fmt::format("{{EffectKind{{{}}}, {}, {}, {}, {}, LocationOptionalEffectCondition{{{}}}, "
+                                         "EffectCondition{{{}}}}}",
+                                         static_cast<int>(spec->kind),
+                                         FormatSkill(spec->skill),
+                                         FormatSkill(spec->optionalSkill),
+                                         spec->activationCost,
+                                         spec->amount,
+                                         static_cast<int>(spec->locationCondition),
+                                         static_cast<int>(spec->condition)));
+    }
+  }
+
+  std::vector<std::string> mInvestigators;
+  std::vector<std::string> mAssets;
+  std::vector<std::string> mActions;
+  std::vector<std::string> mModifications;
+  std::vector<std::string> mEffectSpecs;
+};
+
+Skill GetSkill(const EmbeddedCards::SkillRecord& skill)
+{
+  return Skill{skill.willpower, skill.intellect, skill.combat, skill.agility, skill.wild};
+}
+
+ActionDBData GetAction(const EmbeddedCards::Tables& tables, const EmbeddedCards::ActionRecord& record)
+{
+  ActionDBData action;
+  if (record.hasExpend)
+    action.expend = record.expend;
+  action.action = record.action;
+  action.skill_effect.skill = GetSkill(record.skill);
+  if (record.hasOptional)
+  {
+    action.skill_effect.optional_effect = ActionDBData::SkillEffectsDBData::OptionalEffectDBData{
+      GetSkill(record.optionalSkill), record.what, record.condition};
+  }
+  action.target = record.target;
+  for (const auto& modification: tables.modifications.subspan(record.firstModification, record.modificationCount))
+  {
+    if (modification.isText)
+      action.modifications.insert({modification.key, modification.text});
+    else
+      action.modifications.insert({modification.key, modification.value});
+  }
+  return action;
+}
+
+EffectSpec GetEffectSpec(const EmbeddedCards::EffectSpecRecord& record)
+{
+  EffectSpec spec;
+  spec.kind = record.kind;
+  spec.skill = GetSkill(record.skill);
+  spec.optionalSkill = GetSkill(record.optionalSkill);
+  spec.activationCost = record.activationCost;
+  spec.amount = record.amount;
+  spec.locationCondition = record.locationCondition;
+  spec.condition = record.condition;
+  return spec;
+}
+
+void ReadInvestigators(const EmbeddedCards::Tables& tables, CardDBTables& result)
+{
+  for (const auto& record: tables.investigators)
+  {
+    InvestigatorCardDBData investigator;
+    investigator.name = record.name;
+    investigator.faction = record.faction;
+    investigator.traits = record.traits;
+    investigator.subname = record.subname;
+    investigator.skill = GetSkill(record.skill);
+    investigator.health = record.health;
+    investigator.sanity = record.sanity;
+    result.investigators.insert({investigator.name, investigator});
+  }
+}
+
+void ReadAssets(const EmbeddedCards::Tables& tables, CardDBTables& result)
+{
+  for (const auto& record: tables.assets)
+  {
+    AssetCardDBData asset;
+    asset.name = record.name;
+    asset.faction = record.faction;
+    asset.traits = record.traits;
+    if (record.hasSlot)
+      asset.slot = record.slot;
+    asset.skill = GetSkill(record.skill);
+    asset.cost = record.cost;
+    if (record.hasUses)
+      asset.uses = record.uses;
+    asset.health = record.health;
+    asset.sanity = record.sanity;
+    for (size_t type = 0; type < EmbeddedCards::kEffectTypes; ++type)
+    {
+      auto& actions = asset.effects.at(static_cast<EffectType>(type));
+      for (const auto& action: tables.actions.subspan(record.firstAction[type], record.actionCount[type]))
+        actions.push_back(GetAction(tables, action));
+
+      auto& specs = asset.compiled_effects[static_cast<EffectType>(type)];
+      for (const auto& spec: tables.effectSpecs.subspan(record.firstEffectSpec[type], record.effectSpecCount[type]))
+        specs.push_back(GetEffectSpec(spec));
+    }
+    result.assets.insert({asset.name, asset});
+  }
+}
+} // namespace
+
+std::string EmbeddedCards::WriteHeader(const CardDBTables& tables)
+{
+  HeaderWriter writer;
+
+  // Sorted by name, FindAssetId relies on it and the same data always produces the same header
+  const std::map<std::string_view, InvestigatorCardDBData> investigators{tables.investigators.begin(),
+                                                                         tables.investigators.end()};
+  const std::map<std::string_view, AssetCardDBData> assets{tables.assets.begin(), tables.assets.end()};
+  for (const auto& [_, investigator]: investigators)
+    writer.AddInvestigator(investigator);
+  for (const auto& [_, asset]: assets)
+    writer.AddAsset(asset);
+  return writer.Finish();
+}
+
+void EmbeddedCards::WriteHeaderFile(const CardDBTables& tables, const std::string& path)
+{
+  const auto source = WriteHeader(tables);
+  std::ofstream file{path, std::ios::binary | std::ios::trunc};
+  file << source;
+  if (!file)
+    throw std::runtime_error(fmt::format("Can not write embedded card header '{}'", path));
+}
+
+CardDBTables EmbeddedCards::Read(const Tables& tables)
+{
+  CardDBTables result;
+  Read(tables, CardSection::kInvestigators, result);
+  Read(tables, CardSection::kAssets, result);
+  return result;
+}
+
+void EmbeddedCards::Read(const Tables& tables, const CardSection section, CardDBTables& result)
+{
+  switch (section)
+  {
+    case CardSection::kInvestigators: ReadInvestigators(tables, result); break;
+    case CardSection::kAssets: ReadAssets(tables, result); break;
+    default: break;
+  }
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "card_db_data.h"
+#include "card_id.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+// Card data compiled into the binaries. ArkhamHorror_CardCompiler --cpp turns data/cards.json into a header of
+// constexpr records (embedded_card_data.h, generated in the build tree), so a build with ARKHAM_EMBEDDED_CARDS
+// starts without any file access or json parsing. The records mirror the CardImage ones with string views instead
+// of string pool offsets, plus the EffectSpecs the actions compile to, so the effects are not compiled at startup
+// either.
+class EmbeddedCards
+{
+public:
+  struct SkillRecord
+  {
+    int8_t willpower;
+    int8_t intellect;
+    int8_t combat;
+    int8_t agility;
+    int8_t wild;
+  };
+
+  struct InvestigatorRecord
+  {
+    std::string_view name;
+    std::string_view faction;
+    std::string_view traits;
+    std::string_view subname;
+    SkillRecord skill;
+    uint8_t health;
+    uint8_t sanity;
+  };
+
+  struct ModificationRecord
+  {
+    std::string_view key;
+    std::string_view text; // Only for text modifications (conditions)
+    bool isText;
+    int8_t value;
+  };
+
+  struct ActionRecord
+  {
+    std::string_view action;
+    std::string_view what;
+    std::string_view condition;
+    std::string_view target;
+    uint32_t firstModification;
+    uint32_t modificationCount;
+    SkillRecord skill;
+    SkillRecord optionalSkill;
+    bool hasExpend;
+    uint8_t expend;
+    bool hasOptional;
+  };
+
+  // EffectSpec with the skills as records, so that it can be constexpr
+  struct EffectSpecRecord
+  {
+    EffectKind kind;
+    SkillRecord skill;
+    SkillRecord optionalSkill;
+    uint8_t activationCost;
+    int8_t amount;
+    LocationOptionalEffectCondition locationCondition;
+    EffectCondition condition;
+  };
+
+  // Effect lists are indexed by EffectType
+  static inline constexpr size_t kEffectTypes = static_cast<size_t>(EffectType::kInvalid);
+
+  struct AssetRecord
+  {
+    std::string_view name;
+    std::string_view faction;
+    std::string_view traits;
+    std::string_view slot;
+    std::array<uint32_t, kEffectTypes> firstAction;
+    std::array<uint32_t, kEffectTypes> actionCount;
+    std::array<uint32_t, kEffectTypes> firstEffectSpec;
+    std::array<uint32_t, kEffectTypes> effectSpecCount;
+    SkillRecord skill;
+    uint8_t cost;
+    bool hasSlot;
+    bool hasUses;
+    uint8_t uses;
+    uint8_t health;
+    uint8_t sanity;
+  };
+
+  struct Tables
+  {
+    std::span<const InvestigatorRecord> investigators;
+    std::span<const AssetRecord> assets; // Sorted by name
+    std::span<const ActionRecord> actions;
+    std::span<const ModificationRecord> modifications;
+    std::span<const EffectSpecRecord> effectSpecs;
+  };
+
+  // C++ source of the generated header
+  static std::string WriteHeader(const CardDBTables& tables);
+  static void WriteHeaderFile(const CardDBTables& tables, const std::string& path);
+
+  // The assets come with their compiled_effects already filled
+  static CardDBTables Read(const Tables& tables);
+  // Builds only the data of one section into result
+  static void Read(const Tables& tables, CardSection section, CardDBTables& result);
+
+  // Assets are sorted by name like the card table of CardDB, so the position of a name is its CardId. Usable at
+  // compile time, see EmbeddedCardData::GetAssetId
+  static constexpr CardId FindAssetId(const std::span<const AssetRecord> assets, const std::string_view name)
+  {
+    size_t first = 0;
+    size_t last = assets.size();
+    while (first < last)
+    {
+      const size_t middle = first + (last - first) / 2;
+      if (assets[middle].name < name)
+        first = middle + 1;
+      else
+        last = middle;
+    }
+    return first < assets.size() && assets[first].name == name ? static_cast<CardId>(first) : kInvalidCardId;
+  }
+};
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Epoch based reclamation for data published through an atomic pointer and read without locks. A reader pins the
+// current epoch while it reads, a writer that replaces an object retires it and the object is dropped once every
+// reader that could still see it has unpinned. Pinning is two stores to a slot owned by the reading thread, readers
+// never write a shared cache line nor take a lock. Retired objects are dropped by the next Retire or Reclaim
+class EpochReclaimer
+{
+  struct Slot;
+
+public:
+  static inline EpochReclaimer& Instance()
+  {
+    static EpochReclaimer instance;
+    return instance;
+  }
+
+  // Keeps everything the current thread reads alive until it is destroyed, on the thread that made it. Guards nest,
+  // only the outermost one pins
+  class Guard
+  {
+  public:
+    explicit Guard(EpochReclaimer& reclaimer): mSlot{reclaimer.GetThreadSlot()}
+    {
+      if (mSlot->depth++ == 0)
+        mSlot->epoch.store(reclaimer.mEpoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    }
+
+    ~Guard()
+    {
+      if (--mSlot->depth == 0)
+        mSlot->epoch.store(kIdle, std::memory_order_release);
+    }
+
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+
+  private:
+    Slot* mSlot;
+  };
+
+  // Call after the object was unpublished: no reader pinned later can reach it
+  void Retire(std::shared_ptr<const void> object)
+  {
+    const std::lock_guard lock{mRetiredMutex};
+    mRetired.push_back({mEpoch.fetch_add(1, std::memory_order_seq_cst), std::move(object)});
+    ReclaimLocked();
+  }
+
+  // Drops the retired objects no pinned reader can see anymore
+  void Reclaim()
+  {
+    const std::lock_guard lock{mRetiredMutex};
+    ReclaimLocked();
+  }
+
+  size_t GetRetiredCount() const
+  {
+    const std::lock_guard lock{mRetiredMutex};
+    return mRetired.size();
+  }
+
+private:
+  static inline constexpr uint64_t kIdle = std::numeric_limits<uint64_t>::max();
+
+  struct alignas(64) Slot
+  {
+    std::atomic<uint64_t> epoch{kIdle};
+    uint32_t depth{0}; // Only touched by the thread that owns the slot
+    bool used{false};  // Written under mSlotsMutex
+  };
+
+  // Slot of a thread, given back for another thread to reuse when the thread exits
+  struct SlotLease
+  {
+    explicit SlotLease(EpochReclaimer& reclaimer): reclaimer{reclaimer}, slot{reclaimer.AcquireSlot()} {}
+
+    ~SlotLease()
+    {
+      const std::lock_guard lock{reclaimer.mSlotsMutex};
+      slot->used = false;
+    }
+
+    EpochReclaimer& reclaimer;
+    Slot* slot;
+  };
+
+  struct Retired
+  {
+    uint64_t epoch;
+    std::shared_ptr<const void> object;
+  };
+
+  EpochReclaimer() = default;
+
+  Slot* GetThreadSlot()
+  {
+    // Only one EpochReclaimer exists, a thread registers once
+    thread_local SlotLease lease{*this};
+    return lease.slot;
+  }
+
+  Slot* AcquireSlot()
+  {
+    const std::lock_guard lock{mSlotsMutex};
+    auto it = std::find_if(mSlots.begin(), mSlots.end(), [](const Slot& slot) { return !slot.used; });
+    // A deque never moves its elements, the slots handed out stay valid
+    auto& slot = it == mSlots.end() ? mSlots.emplace_back() : *it;
+    slot.used = true;
+    return &slot;
+  }
+
+  // An object retired at epoch e may have been read by a reader pinned at e or before, and by no other
+  void ReclaimLocked()
+  {
+    uint64_t oldest = kIdle;
+    {
+      const std::lock_guard lock{mSlotsMutex};
+      for (const auto& slot: mSlots)
+        oldest = std::min(oldest, slot.epoch.load(std::memory_order_seq_cst));
+    }
+    std::erase_if(mRetired, [oldest](const Retired& retired) { return retired.epoch < oldest; });
+  }
+
+  std::atomic<uint64_t> mEpoch{0};
+  std::deque<Slot> mSlots;
+  std::mutex mSlotsMutex;
+  std::vector<Retired> mRetired;
+  mutable std::mutex mRetiredMutex;
+};
@@ -5,7 +5,11 @@
 class Event: public Card
 {
 public:
-  Event(const std::string& name, const Faction faction, const Skill& skill, const uint8_t cost, const Slot slot):
+  Event(const std::string_view name,
+        const Faction faction,
+        const Skill& skill,
+        const uint8_t cost,
+        const Slot slot):
     Card{name, faction, skill},
     mCost{cost},
     mSlot{slot}
@@ -23,8 +27,8 @@ static inline bool operator==(const Event& rhs, const Event& lhs)
 {
   return std::tie(rhs.mName, rhs.mFaction, rhs.mTestSkill, rhs.mCost, rhs.mSlot)
            == std::tie(lhs.mName, lhs.mFaction, lhs.mTestSkill, lhs.mCost, lhs.mSlot)
-         && CompareVectorOfSharedPtr(lhs.mActivationEffects, rhs.mActivationEffects)
-         && CompareVectorOfSharedPtr(lhs.mTriggerEffects, rhs.mTriggerEffects);
+         && lhs.mEffects.at(EffectType::kActivate) == rhs.mEffects.at(EffectType::kActivate)
+         && lhs.mEffects.at(EffectType::kTrigger) == rhs.mEffects.at(EffectType::kTrigger);
 }
 
 template<>
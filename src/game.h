@@ -1,7 +1,9 @@
 #pragma once
 
+#include "card_db.h"
 #include "chaos_bag.h"
 #include "player.h"
+#include "trigger_bus.h"
 
 #include <memory>
 #include <vector>
@@ -18,13 +20,63 @@ public:
   void LoadScenario()
   {
     FillChaosBag();
+    // The investigators resolve their tokens for the scenario once, skill tests only look them up
+    for (const auto& player: mPlayers)
+      player->LoadScenario(mScenarioTokens);
   }
 
-  void AddPlayer(const std::unique_ptr<Player> player)
+  // Every random sequence of the game derives from this seed: the chaos bag and each player, including the ones
+  // already added, restart from their own stream of it
+  void Seed(const uint64_t seed)
   {
+    mGenerator = Philox4x32{seed};
+    mChaosBag.SetGenerator(mGenerator.Split(kChaosBagStream));
+    for (size_t index = 0; index < mPlayers.size(); ++index)
+      mPlayers[index]->SetGenerator(GetGenerator(index));
+  }
+
+  Philox4x32 GetGenerator(const size_t playerIndex) const
+  {
+    return mGenerator.Split(kFirstPlayerStream + playerIndex);
+  }
+
+  // Card data of the game, taken when it starts: the players are created from it and the card ids of their decks,
+  // hands and commits are resolved from it, whatever Reload happens meanwhile
+  const std::shared_ptr<const CardDB::Snapshot>& GetSnapshot() const
+  {
+    return mSnapshot;
+  }
+
+  void AddPlayer(std::unique_ptr<Player> player)
+  {
+    player->SetGenerator(GetGenerator(mPlayers.size()));
     mPlayers.push_back(std::move(player));
   }
 
+  // While a card is in play its trigger effects are subscribed and its passive modifiers count for its player
+  void EnterPlay(const size_t playerIndex, const CardInPlayId card, const Card& data)
+  {
+    mTriggers.Subscribe(card, data);
+    mPlayers.at(playerIndex)->GetPassives().Add(card, data);
+  }
+
+  void LeavePlay(const size_t playerIndex, const CardInPlayId card)
+  {
+    mTriggers.Unsubscribe(card);
+    mPlayers.at(playerIndex)->GetPassives().Remove(card);
+  }
+
+  // A blanked card stays in play but stops adding its passive modifiers
+  void SetPassiveActive(const size_t playerIndex, const CardInPlayId card, const bool active)
+  {
+    mPlayers.at(playerIndex)->GetPassives().SetActive(card, active);
+  }
+
+  const TriggerBus& GetTriggers() const
+  {
+    return mTriggers;
+  }
+
 protected:
   void FillChaosBag()
   {
@@ -51,6 +103,15 @@ protected:
 
   ~Game() noexcept = default;
 
+  static inline constexpr uint64_t kChaosBagStream = 0;
+  static inline constexpr uint64_t kFirstPlayerStream = 1;
+
+  std::shared_ptr<const CardDB::Snapshot> mSnapshot{CardDB::Instance().GetSnapshot()};
   std::vector<std::unique_ptr<Player>> mPlayers;
-  ChaosBagImpl mChaosBag;
+  // Hardcoded with first scenario, its symbol tokens keep the values they have in the chaos bag
+  ScenarioTokens mScenarioTokens;
+  TriggerBus mTriggers;
+  // Unseeded games are not reproducible, Seed replaces it
+  Philox4x32 mGenerator{Philox4x32::FromEntropy()};
+  ChaosBagImpl mChaosBag{mGenerator.Split(kChaosBagStream)};
 };
\ No newline at end of file
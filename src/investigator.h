@@ -1,33 +1,61 @@
 #pragma once
 
+#include "effect.h"
 #include "skill.h"
 #include "spdlog/spdlog.h"
+#include "string_interner.h"
+#include "trait.h"
 
-#include <memory>
+#include <optional>
 #include <ostream>
 #include <string>
+#include <string_view>
 
 class Investigator
 {
 public:
-  Investigator(const std::string& name,
+  Investigator(const std::string_view name,
                const Faction faction,
                const Skill& skill,
                const uint8_t health,
                const uint8_t sanity):
-    mName{name},
+    mName{StringInterner::Instance().Intern(name)},
     mFaction{faction},
     mSkill{skill},
     mHealth{health},
-    mSanity{sanity},
-    mElderSign{nullptr}
+    mSanity{sanity}
   {}
 
-  void RegisterElderSign(const std::shared_ptr<Effect>& effect)
+  void RegisterElderSign(EffectVariant effect)
   {
     mElderSign = std::move(effect);
   }
 
+  const std::optional<EffectVariant>& GetElderSign() const
+  {
+    return mElderSign;
+  }
+
+  std::string_view GetName() const
+  {
+    return StringInterner::Instance().Get(mName);
+  }
+
+  NameHandle GetNameHandle() const
+  {
+    return mName;
+  }
+
+  void SetTraits(const TraitMask& traits)
+  {
+    mTraits = traits;
+  }
+
+  const TraitMask& GetTraits() const
+  {
+    return mTraits;
+  }
+
   const Skill& GetSkill() const
   {
     return mSkill;
@@ -44,10 +72,10 @@ public:
   }
 
 private:
-  std::string mName;
-  std::string mTraits;
+  NameHandle mName;
+  TraitMask mTraits;
   Faction mFaction;
-  std::shared_ptr<Effect> mElderSign;
+  std::optional<EffectVariant> mElderSign;
   Skill mSkill;
   uint8_t mHealth;
   uint8_t mSanity;
@@ -68,7 +96,7 @@ struct fmt::formatter<Investigator>: fmt::formatter<std::string>
   {
     auto it = fmt::format_to(ctx.out(),
                              "'name': {}, 'traits': {}, 'faction': {}",
-                             investigator.mName,
+                             investigator.GetName(),
                              investigator.mTraits,
                              StringToEnum::GetString<Faction>(investigator.mFaction));
     return fmt::format_to(it,
@@ -0,0 +1,84 @@
+#include "mapped_file.h"
+
+#include "spdlog/spdlog.h"
+
+#include <stdexcept>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path)
+{
+  mFile = CreateFileA(path.c_str(),
+                      GENERIC_READ,
+                      FILE_SHARE_READ,
+                      nullptr,
+                      OPEN_EXISTING,
+                      FILE_ATTRIBUTE_NORMAL,
+                      nullptr);
+  if (mFile == INVALID_HANDLE_VALUE)
+    throw std::runtime_error(fmt::format("Can not open '{}'", path));
+
+  LARGE_INTEGER size;
+  if (!GetFileSizeEx(mFile, &size) || size.QuadPart == 0)
+  {
+    CloseHandle(mFile);
+    throw std::runtime_error(fmt::format("Can not map empty file '{}'", path));
+  }
+  mSize = static_cast<size_t>(size.QuadPart);
+
+  mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mMapping != nullptr)
+    mData = MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+  if (mData == nullptr)
+  {
+    if (mMapping != nullptr)
+      CloseHandle(mMapping);
+    CloseHandle(mFile);
+    throw std::runtime_error(fmt::format("Can not map '{}'", path));
+  }
+}
+
+MappedFile::~MappedFile()
+{
+  UnmapViewOfFile(mData);
+  CloseHandle(mMapping);
+  CloseHandle(mFile);
+}
+#else
+MappedFile::MappedFile(const std::string& path)
+{
+  const int file = open(path.c_str(), O_RDONLY);
+  if (file < 0)
+    throw std::runtime_error(fmt::format("Can not open '{}'", path));
+
+  struct stat status;
+  if (fstat(file, &status) != 0 || status.st_size == 0)
+  {
+    close(file);
+    throw std::runtime_error(fmt::format("Can not map empty file '{}'", path));
+  }
+  mSize = static_cast<size_t>(status.st_size);
+
+  void* data = mmap(nullptr, mSize, PROT_READ, MAP_SHARED, file, 0);
+  // The mapping keeps the file alive, the descriptor is not needed anymore
+  close(file);
+  if (data == MAP_FAILED)
+    throw std::runtime_error(fmt::format("Can not map '{}'", path));
+  mData = data;
+}
+
+MappedFile::~MappedFile()
+{
+  munmap(const_cast<void*>(mData), mSize);
+}
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Read only memory mapping of a whole file. Every process mapping the same file shares its pages from the page
+// cache, nothing is copied into the process.
+class MappedFile
+{
+public:
+  explicit MappedFile(const std::string& path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  const std::byte* Data() const
+  {
+    return static_cast<const std::byte*>(mData);
+  }
+
+  size_t Size() const
+  {
+    return mSize;
+  }
+
+private:
+  const void* mData{nullptr};
+  size_t mSize{0};
+#ifdef _WIN32
+  void* mFile{nullptr};
+  void* mMapping{nullptr};
+#endif
+};
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+// Minimal perfect hash over a frozen set of string keys (hash and displace): keys are spread in buckets by a first
+// hash, then every bucket gets the seed of a second hash that sends each of its keys to a free slot. A lookup is
+// two hashes and one key comparison, whatever the number of keys. The keys are not copied and must outlive the
+// index
+class PerfectHash
+{
+public:
+  static inline constexpr uint32_t kNotFound = UINT32_MAX;
+
+  PerfectHash() = default;
+
+  // Keys must be unique. Lookup(keys[i]) is i
+  explicit PerfectHash(std::vector<std::string_view> keys): mKeys{std::move(keys)}
+  {
+    const auto size = static_cast<uint32_t>(mKeys.size());
+    if (size == 0)
+      return;
+
+    mSeeds.assign(size, 0);
+    mSlots.assign(size, kNotFound);
+
+    std::vector<std::vector<uint32_t>> buckets(size);
+    for (uint32_t i = 0; i < size; ++i)
+      buckets[Hash(mKeys[i], 0) % size].push_back(i);
+
+    // Placing the crowded buckets first keeps the seed search short, single keys fill whatever is left
+    std::vector<uint32_t> order(size);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&buckets](const uint32_t lhs, const uint32_t rhs) {
+      return buckets[lhs].size() > buckets[rhs].size();
+    });
+
+    std::vector<uint32_t> slots;
+    for (const auto bucket: order)
+    {
+      if (buckets[bucket].empty())
+        break;
+
+      for (uint32_t seed = 1;; ++seed)
+      {
+        if (seed == kMaxSeed)
+          throw std::runtime_error(fmt::format("Can not build a perfect hash of {} keys", size));
+
+        slots.clear();
+        const bool placed = std::all_of(buckets[bucket].begin(), buckets[bucket].end(), [&](const uint32_t key) {
+          const auto slot = static_cast<uint32_t>(Hash(mKeys[key], seed) % size);
+          if (mSlots[slot] != kNotFound || std::find(slots.begin(), slots.end(), slot) != slots.end())
+            return false;
+          slots.push_back(slot);
+          return true;
+        });
+        if (!placed)
+          continue;
+
+        mSeeds[bucket] = seed;
+        for (size_t i = 0; i < slots.size(); ++i)
+          mSlots[slots[i]] = buckets[bucket][i];
+        break;
+      }
+    }
+  }
+
+  // Index of key in the keys the hash was built from, kNotFound if it is not one of them
+  uint32_t Lookup(const std::string_view key) const
+  {
+    if (mKeys.empty())
+      return kNotFound;
+
+    const auto size = mKeys.size();
+    const auto index = mSlots[Hash(key, mSeeds[Hash(key, 0) % size]) % size];
+    return mKeys[index] == key ? index : kNotFound;
+  }
+
+  size_t Size() const
+  {
+    return mKeys.size();
+  }
+
+  // Seeded FNV-1a with a murmur finalizer, usable at compile time
+  static constexpr uint64_t Hash(const std::string_view key, const uint64_t seed)
+  {
+    uint64_t hash = 0xcbf29ce484222325ull ^ (seed * 0x9e3779b97f4a7c15ull);
+    for (const char c: key)
+    {
+      hash ^= static_cast<uint8_t>(c);
+      hash *= 0x100000001b3ull;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ull;
+    return hash ^ (hash >> 33);
+  }
+
+private:
+  static inline constexpr uint32_t kMaxSeed = 1u << 24;
+
+  std::vector<std::string_view> mKeys;
+  std::vector<uint32_t> mSeeds;
+  std::vector<uint32_t> mSlots;
+};
@@ -1,8 +1,10 @@
 #pragma once
 
-#include "card_factory.h"
+#include "card_db.h"
 #include "deck.h"
 #include "skill.h"
+#include "skill_aggregate.h"
+#include "token_table.h"
 
 #include <memory>
 #include <queue>
@@ -14,17 +16,40 @@ class Player
 public:
   virtual ~Player() = default;
   virtual const Skill& GetSkill() const = 0;
+  // Passive modifiers of the cards the player has in play, added to every skill test
+  virtual Skill GetSkillModifier() const = 0;
+  // Updated by Game as the player's cards enter and leave play
+  virtual SkillAggregate& GetPassives() = 0;
+  // How the chaos tokens resolve for the investigator in the current scenario
+  virtual const TokenTable& GetTokenTable() const = 0;
+  virtual void LoadScenario(const ScenarioTokens& scenario) = 0;
   virtual uint8_t GetDamagePool() const = 0;
   virtual uint8_t GetHorrorPool() const = 0;
   virtual void DrawCard() = 0;
+  // Hand and deck shuffles draw from sub streams of generator, Game hands every player its own stream
+  virtual void SetGenerator(const Philox4x32& generator) = 0;
 };
 
 class PlayerImpl: public Player
 {
 public:
-  PlayerImpl(const std::string& name, const std::string& investigatorName)
+  // 30 cards plus signature cards and weaknesses, hands are bounded by the same amount
+  static inline constexpr size_t kDeckCapacity = 64;
+  // Decks only hold ids into the CardDB card table, copying or hashing one is a copy of a flat array
+  using CardRing = RingBuffer<CardId, kDeckCapacity>;
+
+  // The ids of the deck and the hand refer to the card table of snapshot, the one of the game the player is in, so
+  // a Reload does not change the cards they are
+  PlayerImpl(const std::string& name,
+             const std::string& investigatorName,
+             std::shared_ptr<const CardDB::Snapshot> snapshot,
+             const Philox4x32& generator):
+    mSnapshot{std::move(snapshot)},
+    mHand{generator.Split(kHandStream)},
+    mDeck{generator.Split(kDeckStream)}
   {
-    mInvestigator = CardFactory::CreateCard<Investigator>(investigatorName);
+    mInvestigator = mSnapshot->GetCard<Investigator>(investigatorName);
+    mTokenTable = TokenTable::Build(*mInvestigator);
   }
 
   const Skill& GetSkill() const override
@@ -32,6 +57,28 @@ public:
     return mInvestigator->GetSkill();
   }
 
+  Skill GetSkillModifier() const override
+  {
+    return mPassives.Get();
+  }
+
+  SkillAggregate& GetPassives() override
+  {
+    return mPassives;
+  }
+
+  // Resolves the chaos tokens with the scenario modifiers and the investigator elder sign once, skill tests only
+  // look them up
+  void LoadScenario(const ScenarioTokens& scenario) override
+  {
+    mTokenTable = TokenTable::Build(*mInvestigator, scenario);
+  }
+
+  const TokenTable& GetTokenTable() const override
+  {
+    return mTokenTable;
+  }
+
   uint8_t GetDamagePool() const override
   {
     return mDamagePool;
@@ -42,16 +89,44 @@ public:
     return mHorrorPool;
   }
 
+  // Commits and skill tests resolve the ids of the hand from it
+  const CardDB::Snapshot& GetSnapshot() const
+  {
+    return *mSnapshot;
+  }
+
+  const CardRing& GetHand() const
+  {
+    return mHand.GetCards();
+  }
+
+  void AddCardToDeck(const CardId card)
+  {
+    mDeck.AddCard(card);
+  }
+
   void DrawCard() override
   {
     auto card = mDeck.DrawCard();
     mHand.AddCard(std::move(card));
   }
 
+  void SetGenerator(const Philox4x32& generator) override
+  {
+    mHand.SetGenerator(generator.Split(kHandStream));
+    mDeck.SetGenerator(generator.Split(kDeckStream));
+  }
+
 private:
-  std::shared_ptr<Investigator> mInvestigator;
-  DeckImpl<std::vector<std::shared_ptr<Card>>> mHand;
-  DeckImpl<std::queue<std::shared_ptr<Card>>> mDeck;
+  static inline constexpr uint64_t kHandStream = 0;
+  static inline constexpr uint64_t kDeckStream = 1;
+
+  std::shared_ptr<const CardDB::Snapshot> mSnapshot;
+  std::shared_ptr<const Investigator> mInvestigator;
+  DeckImpl<CardRing> mHand;
+  DeckImpl<CardRing> mDeck;
+  SkillAggregate mPassives;
+  TokenTable mTokenTable;
   uint8_t mDamagePool{0};
   uint8_t mHorrorPool{0};
 };
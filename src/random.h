@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+// Philox4x32-10 counter based generator (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+// Every block of four outputs is a pure function of (key, counter): the key is the seed, the upper half of the
+// counter is the stream and the lower half the position in it. Independent sequences for each game, thread or
+// purpose are just different streams of the same seed, with no state shared between them.
+// Satisfies UniformRandomBitGenerator so it can be used with std::shuffle and the std distributions.
+class Philox4x32
+{
+public:
+  using result_type = uint32_t;
+
+  static constexpr result_type min()
+  {
+    return std::numeric_limits<result_type>::min();
+  }
+
+  static constexpr result_type max()
+  {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  explicit Philox4x32(const uint64_t seed = 0, const uint64_t stream = 0):
+    mKey{Low(seed), High(seed)},
+    mCounter{0, 0, Low(stream), High(stream)}
+  {}
+
+  // Only for callers that do not care about reproducibility, simulations should always pass an explicit seed
+  static Philox4x32 FromEntropy()
+  {
+    std::random_device rd;
+    return Philox4x32{(static_cast<uint64_t>(rd()) << 32) | rd(), (static_cast<uint64_t>(rd()) << 32) | rd()};
+  }
+
+  // Independent generator for a sub stream of this one, e.g. Philox4x32{seed, game}.Split(thread).Split(kDeck)
+  Philox4x32 Split(const uint64_t subStream) const
+  {
+    const uint64_t stream = (static_cast<uint64_t>(mCounter[3]) << 32) | mCounter[2];
+    return Philox4x32{GetSeed(), Mix(stream ^ Mix(subStream + 1))};
+  }
+
+  uint64_t GetSeed() const
+  {
+    return (static_cast<uint64_t>(mKey[1]) << 32) | mKey[0];
+  }
+
+  result_type operator()()
+  {
+    if (mIndex == mBlock.size())
+    {
+      mBlock = Generate(mCounter, mKey);
+      mIndex = 0;
+      // Only the position half of the counter moves, the stream half is fixed
+      if (++mCounter[0] == 0)
+        ++mCounter[1];
+    }
+    return mBlock[mIndex++];
+  }
+
+  void discard(unsigned long long n)
+  {
+    for (; n > 0 && mIndex != mBlock.size(); --n)
+      ++mIndex;
+    const uint64_t position = ((static_cast<uint64_t>(mCounter[1]) << 32) | mCounter[0]) + n / mBlock.size();
+    mCounter[0] = Low(position);
+    mCounter[1] = High(position);
+    for (n %= mBlock.size(); n > 0; --n)
+      operator()();
+  }
+
+  using Counter = std::array<uint32_t, 4>;
+  using Key = std::array<uint32_t, 2>;
+
+  static Counter Generate(Counter counter, Key key)
+  {
+    for (int round = 0; round < kRounds; ++round)
+    {
+      if (round > 0)
+      {
+        key[0] += kWeyl0;
+        key[1] += kWeyl1;
+      }
+      const uint64_t product0 = static_cast<uint64_t>(kMultiplier0) * counter[0];
+      const uint64_t product1 = static_cast<uint64_t>(kMultiplier1) * counter[2];
+      counter = {High(product1) ^ counter[1] ^ key[0],
+                 Low(product1),
+                 High(product0) ^ counter[3] ^ key[1],
+                 Low(product0)};
+    }
+    return counter;
+  }
+
+  friend bool operator==(const Philox4x32& lhs, const Philox4x32& rhs) = default;
+
+private:
+  static inline constexpr int kRounds = 10;
+  static inline constexpr uint32_t kMultiplier0 = 0xD2511F53;
+  static inline constexpr uint32_t kMultiplier1 = 0xCD9E8D57;
+  static inline constexpr uint32_t kWeyl0 = 0x9E3779B9;
+  static inline constexpr uint32_t kWeyl1 = 0xBB67AE85;
+
+  static constexpr uint32_t Low(const uint64_t value)
+  {
+    return static_cast<uint32_t>(value);
+  }
+
+  static constexpr uint32_t High(const uint64_t value)
+  {
+    return static_cast<uint32_t>(value >> 32);
+  }
+
+  // splitmix64 finalizer, spreads consecutive sub stream ids over the whole stream space
+  static constexpr uint64_t Mix(uint64_t value)
+  {
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+  }
+
+  Key mKey;
+  Counter mCounter;
+  Counter mBlock{};
+  size_t mIndex{mBlock.size()};
+};
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Fixed capacity FIFO with inline storage. push_back and pop_front are O(1) and never allocate, and the random
+// access iterators walk the elements in queue order, so the content can be shuffled in place with std::shuffle.
+template<typename T, size_t N>
+class RingBuffer
+{
+  template<bool Const>
+  class Iterator
+  {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = T;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const T*, T*>;
+    using reference = std::conditional_t<Const, const T&, T&>;
+    using Ring = std::conditional_t<Const, const RingBuffer, RingBuffer>;
+
+    Iterator() = default;
+    Iterator(Ring* ring, const size_t index): mRing{ring}, mIndex{index} {}
+
+    reference operator*() const
+    {
+      return (*mRing)[mIndex];
+    }
+
+    pointer operator->() const
+    {
+      return &(*mRing)[mIndex];
+    }
+
+    reference operator[](const difference_type offset) const
+    {
+      return (*mRing)[mIndex + offset];
+    }
+
+    Iterator& operator++()
+    {
+      ++mIndex;
+      return *this;
+    }
+
+    Iterator operator++(int)
+    {
+      auto it = *this;
+      ++mIndex;
+      return it;
+    }
+
+    Iterator& operator--()
+    {
+      --mIndex;
+      return *this;
+    }
+
+    Iterator operator--(int)
+    {
+      auto it = *this;
+      --mIndex;
+      return it;
+    }
+
+    Iterator& operator+=(const difference_type offset)
+    {
+      mIndex += offset;
+      return *this;
+    }
+
+    Iterator& operator-=(const difference_type offset)
+    {
+      mIndex -= offset;
+      return *this;
+    }
+
+    friend Iterator operator+(Iterator it, const difference_type offset)
+    {
+      return it += offset;
+    }
+
+    friend Iterator operator+(const difference_type offset, Iterator it)
+    {
+      return it += offset;
+    }
+
+    friend Iterator operator-(Iterator it, const difference_type offset)
+    {
+      return it -= offset;
+    }
+
+    friend difference_type operator-(const Iterator& lhs, const Iterator& rhs)
+    {
+      return static_cast<difference_type>(lhs.mIndex) - static_cast<difference_type>(rhs.mIndex);
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs)
+    {
+      return lhs.mIndex == rhs.mIndex;
+    }
+
+    friend auto operator<=>(const Iterator& lhs, const Iterator& rhs)
+    {
+      return lhs.mIndex <=> rhs.mIndex;
+    }
+
+  private:
+    Ring* mRing{nullptr};
+    size_t mIndex{0}; // Position from the front of the queue
+  };
+
+public:
+  using value_type = T;
+  using size_type = size_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  void push_back(T value)
+  {
+    if (mSize == N)
+      throw std::length_error("RingBuffer is full");
+    (*this)[mSize] = std::move(value);
+    ++mSize;
+  }
+
+  T& front()
+  {
+    CheckNotEmpty();
+    return mValues[mHead];
+  }
+
+  const T& front() const
+  {
+    CheckNotEmpty();
+    return mValues[mHead];
+  }
+
+  void pop_front()
+  {
+    CheckNotEmpty();
+    // Reset the slot so that it does not keep a copy of what was drawn alive
+    mValues[mHead] = T{};
+    mHead = mHead + 1 == N ? 0 : mHead + 1;
+    --mSize;
+  }
+
+  T& operator[](const size_t index)
+  {
+    return mValues[Wrap(index)];
+  }
+
+  const T& operator[](const size_t index) const
+  {
+    return mValues[Wrap(index)];
+  }
+
+  bool empty() const
+  {
+    return mSize == 0;
+  }
+
+  size_t size() const
+  {
+    return mSize;
+  }
+
+  static constexpr size_t capacity()
+  {
+    return N;
+  }
+
+  iterator begin()
+  {
+    return {this, 0};
+  }
+
+  iterator end()
+  {
+    return {this, mSize};
+  }
+
+  const_iterator begin() const
+  {
+    return {this, 0};
+  }
+
+  const_iterator end() const
+  {
+    return {this, mSize};
+  }
+
+  // FNV-1a over the elements in queue order, only for trivially copyable elements like CardId
+  size_t Hash() const
+    requires std::is_trivially_copyable_v<T>
+  {
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (const auto& value: *this)
+    {
+      const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+      for (size_t i = 0; i < sizeof(T); ++i)
+        hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+    }
+    return static_cast<size_t>(hash);
+  }
+
+private:
+  void CheckNotEmpty() const
+  {
+    if (mSize == 0)
+      throw std::out_of_range("RingBuffer is empty");
+  }
+
+  size_t Wrap(const size_t index) const
+  {
+    const size_t position = mHead + index;
+    return position >= N ? position - N : position;
+  }
+
+  std::array<T, N> mValues{};
+  size_t mHead{0};
+  size_t mSize{0};
+};
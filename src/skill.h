@@ -2,6 +2,7 @@
 
 #include "spdlog/spdlog.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <tuple>
 
@@ -34,6 +35,26 @@ static inline bool operator==(const Skill& lhs, const Skill& rhs)
          == std::tie(rhs.willpower, rhs.intellect, rhs.combat, rhs.agility, rhs.wild);
 }
 
+static inline Skill& operator+=(Skill& lhs, const Skill& rhs)
+{
+  lhs.willpower += rhs.willpower;
+  lhs.intellect += rhs.intellect;
+  lhs.combat += rhs.combat;
+  lhs.agility += rhs.agility;
+  lhs.wild += rhs.wild;
+  return lhs;
+}
+
+static inline Skill& operator-=(Skill& lhs, const Skill& rhs)
+{
+  lhs.willpower -= rhs.willpower;
+  lhs.intellect -= rhs.intellect;
+  lhs.combat -= rhs.combat;
+  lhs.agility -= rhs.agility;
+  lhs.wild -= rhs.wild;
+  return lhs;
+}
+
 template<>
 struct fmt::formatter<Skill>: fmt::formatter<std::string>
 {
@@ -49,8 +70,11 @@ struct fmt::formatter<Skill>: fmt::formatter<std::string>
   }
 };
 
+// Skill selectors for SkillTest, kIndex is the lane of the skill in a PackedSkill
 struct Willpower
 {
+  static inline constexpr size_t kIndex = 0;
+
   static inline int8_t GetSkillValue(const Skill& skill)
   {
     return skill.willpower + skill.wild;
@@ -59,6 +83,8 @@ struct Willpower
 
 struct Combat
 {
+  static inline constexpr size_t kIndex = 2;
+
   static inline int8_t GetSkillValue(const Skill& skill)
   {
     return skill.combat + skill.wild;
@@ -67,6 +93,8 @@ struct Combat
 
 struct Intellect
 {
+  static inline constexpr size_t kIndex = 1;
+
   static inline int8_t GetSkillValue(const Skill& skill)
   {
     return skill.intellect + skill.wild;
@@ -75,6 +103,8 @@ struct Intellect
 
 struct Agility
 {
+  static inline constexpr size_t kIndex = 3;
+
   static inline int8_t GetSkillValue(const Skill& skill)
   {
     return skill.agility + skill.wild;
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "card.h"
+#include "card_id.h"
+#include "skill.h"
+#include "spdlog/spdlog.h"
+
+#include <stdexcept>
+#include <unordered_map>
+
+// Skill a card adds while it is in play: its passive effects that modify the skills unconditionally. Passive
+// effects that only apply to some actions (a fight against an engaged enemy...) are resolved with the action
+inline Skill GetPassiveSkill(const Card& card)
+{
+  Skill skill;
+  for (const auto& effect: card.GetPasiveEffect())
+  {
+    if (const auto* modifier = std::get_if<Effect>(&effect))
+      skill += modifier->GetSkill();
+  }
+  return skill;
+}
+
+// Sum of the passive skill modifiers of the cards a player has in play. It is updated when a card enters or
+// leaves play or its passive effects are switched on or off, so reading it is O(1). Debug builds check every
+// update against the sum recomputed from the cards
+class SkillAggregate
+{
+public:
+  // The card must outlive its entry
+  void Add(const CardInPlayId owner, const Card& card)
+  {
+    Remove(owner);
+    const auto& entry = mEntries.insert({owner, Entry{&card, GetPassiveSkill(card), true}}).first->second;
+    mTotal += entry.skill;
+    CheckConsistency();
+  }
+
+  void Remove(const CardInPlayId owner)
+  {
+    const auto it = mEntries.find(owner);
+    if (it == mEntries.end())
+      return;
+
+    if (it->second.active)
+      mTotal -= it->second.skill;
+    mEntries.erase(it);
+    CheckConsistency();
+  }
+
+  // Switches the passive effects of a card in play on or off (a blank, an exhausted ally...)
+  void SetActive(const CardInPlayId owner, const bool active)
+  {
+    const auto it = mEntries.find(owner);
+    if (it == mEntries.end() || it->second.active == active)
+      return;
+
+    it->second.active = active;
+    if (active)
+      mTotal += it->second.skill;
+    else
+      mTotal -= it->second.skill;
+    CheckConsistency();
+  }
+
+  const Skill& Get() const
+  {
+    return mTotal;
+  }
+
+private:
+  struct Entry
+  {
+    const Card* card;
+    Skill skill;
+    bool active;
+  };
+
+  void CheckConsistency() const
+  {
+#ifndef NDEBUG
+    Skill total;
+    for (const auto& [_, entry]: mEntries)
+    {
+      if (entry.active)
+        total += GetPassiveSkill(*entry.card);
+    }
+    if (!(total == mTotal))
+    {
+      throw std::logic_error(
+        fmt::format("Passive skill aggregate is {} but the cards in play add {}", mTotal, total));
+    }
+#endif
+  }
+
+  std::unordered_map<CardInPlayId, Entry> mEntries;
+  Skill mTotal;
+};
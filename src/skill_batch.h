@@ -0,0 +1,201 @@
+#pragma once
+
+#include "card.h"
+#include "skill.h"
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+// The AVX2 kernel is only compiled with -mavx2 or /arch:AVX2, the ARKHAM_SKILL_BATCH_AVX2 CMake option sets them
+#if !defined(ARKHAM_DISABLE_SIMD)
+#if defined(__AVX2__)
+#define ARKHAM_SKILL_BATCH_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ARKHAM_SKILL_BATCH_SSE2
+#include <emmintrin.h>
+#endif
+#endif
+
+// Effective value of the four testable skills with the wild icons already added, one byte per skill in the order
+// given by Willpower/Intellect/Combat/Agility::kIndex. Every sum saturates at the int8_t limits.
+struct PackedSkill
+{
+  static inline constexpr size_t kSkills = 4;
+
+  std::array<int8_t, kSkills> values{};
+
+  static inline int8_t SaturatedAdd(const int a, const int b)
+  {
+    return static_cast<int8_t>(std::clamp(a + b, -128, 127));
+  }
+
+  static inline PackedSkill FromSkill(const Skill& skill)
+  {
+    PackedSkill packed;
+    packed.values[Willpower::kIndex] = SaturatedAdd(skill.willpower, skill.wild);
+    packed.values[Intellect::kIndex] = SaturatedAdd(skill.intellect, skill.wild);
+    packed.values[Combat::kIndex] = SaturatedAdd(skill.combat, skill.wild);
+    packed.values[Agility::kIndex] = SaturatedAdd(skill.agility, skill.wild);
+    return packed;
+  }
+
+  // Icons of all the commited cards
+  static inline PackedSkill FromCards(const std::vector<std::shared_ptr<Card>>& commitedCards)
+  {
+    PackedSkill packed;
+    for (const auto& card: commitedCards)
+      packed += FromSkill(card->GetSkill());
+    return packed;
+  }
+
+  // Difficulty of a test against skillTested, negative difficulties count as 0 like in SkillTest
+  static inline PackedSkill FromDifficulty(const Skill& skillTested)
+  {
+    PackedSkill packed = FromSkill(skillTested);
+    std::for_each(packed.values.begin(),
+                  packed.values.end(),
+                  [](auto& value) { value = std::max<int8_t>(value, 0); });
+    return packed;
+  }
+
+  PackedSkill& operator+=(const PackedSkill& other)
+  {
+    for (size_t i = 0; i < kSkills; ++i)
+      values[i] = SaturatedAdd(values[i], other.values[i]);
+    return *this;
+  }
+};
+
+static inline bool operator==(const PackedSkill& lhs, const PackedSkill& rhs)
+{
+  return lhs.values == rhs.values;
+}
+
+// Evaluates many skill tests at once against all four skills:
+//   margin = investigator skill + commited icons + token modifier - difficulty, success = margin >= 0
+// Inputs are stored as structure of arrays so the kernel runs 32 (AVX2) or 16 (SSE2) lanes per instruction.
+class SkillTestBatch
+{
+public:
+  void Reserve(const size_t tests)
+  {
+    for (auto* values: {&mSkills, &mCommited, &mModifiers, &mDifficulties})
+      values->reserve(tests * PackedSkill::kSkills);
+  }
+
+  // Returns the index of the test inside the batch
+  size_t Add(const PackedSkill& investigator,
+             const PackedSkill& commited,
+             const int8_t tokenModifier,
+             const PackedSkill& difficulty)
+  {
+    mSkills.insert(mSkills.end(), investigator.values.begin(), investigator.values.end());
+    mCommited.insert(mCommited.end(), commited.values.begin(), commited.values.end());
+    mModifiers.insert(mModifiers.end(), PackedSkill::kSkills, tokenModifier);
+    mDifficulties.insert(mDifficulties.end(), difficulty.values.begin(), difficulty.values.end());
+    return Size() - 1;
+  }
+
+  size_t Size() const
+  {
+    return mSkills.size() / PackedSkill::kSkills;
+  }
+
+  void Clear()
+  {
+    for (auto* values: {&mSkills, &mCommited, &mModifiers, &mDifficulties, &mMargins})
+      values->clear();
+    mSuccess.clear();
+  }
+
+  void Evaluate()
+  {
+    mMargins.resize(mSkills.size());
+    mSuccess.resize(mSkills.size());
+    Evaluate(mSkills.data(),
+             mCommited.data(),
+             mModifiers.data(),
+             mDifficulties.data(),
+             mMargins.data(),
+             mSuccess.data(),
+             mSkills.size());
+  }
+
+  template<typename T>
+  int8_t GetMargin(const size_t test) const
+  {
+    return mMargins[test * PackedSkill::kSkills + T::kIndex];
+  }
+
+  template<typename T>
+  bool Succeeds(const size_t test) const
+  {
+    return mSuccess[test * PackedSkill::kSkills + T::kIndex] != 0;
+  }
+
+  // Element wise kernel over count bytes, success is written as 1/0
+  static void Evaluate(const int8_t* skills,
+                       const int8_t* commited,
+                       const int8_t* modifiers,
+                       const int8_t* difficulties,
+                       int8_t* margins,
+                       uint8_t* success,
+                       const size_t count)
+  {
+    size_t i = 0;
+#if defined(ARKHAM_SKILL_BATCH_AVX2)
+    const __m256i one = _mm256_set1_epi8(1);
+    for (; i + 32 <= count; i += 32)
+    {
+      auto load = [i](const int8_t* values)
+      { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)); };
+      const __m256i difficulty = load(difficulties);
+      const __m256i result = _mm256_adds_epi8(_mm256_adds_epi8(load(skills), load(commited)), load(modifiers));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(margins + i), _mm256_subs_epi8(result, difficulty));
+      const __m256i fails = _mm256_cmpgt_epi8(difficulty, result);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(success + i), _mm256_andnot_si256(fails, one));
+    }
+#elif defined(ARKHAM_SKILL_BATCH_SSE2)
+    const __m128i one = _mm_set1_epi8(1);
+    for (; i + 16 <= count; i += 16)
+    {
+      auto load = [i](const int8_t* values)
+      { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)); };
+      const __m128i difficulty = load(difficulties);
+      const __m128i result = _mm_adds_epi8(_mm_adds_epi8(load(skills), load(commited)), load(modifiers));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(margins + i), _mm_subs_epi8(result, difficulty));
+      const __m128i fails = _mm_cmpgt_epi8(difficulty, result);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(success + i), _mm_andnot_si128(fails, one));
+    }
+#endif
+    EvaluateScalar(skills + i, commited + i, modifiers + i, difficulties + i, margins + i, success + i, count - i);
+  }
+
+  static void EvaluateScalar(const int8_t* skills,
+                             const int8_t* commited,
+                             const int8_t* modifiers,
+                             const int8_t* difficulties,
+                             int8_t* margins,
+                             uint8_t* success,
+                             const size_t count)
+  {
+    for (size_t i = 0; i < count; ++i)
+    {
+      const int8_t sum = PackedSkill::SaturatedAdd(skills[i], commited[i]);
+      const int8_t result = PackedSkill::SaturatedAdd(sum, modifiers[i]);
+      margins[i] = PackedSkill::SaturatedAdd(result, -difficulties[i]);
+      success[i] = result >= difficulties[i];
+    }
+  }
+
+private:
+  std::vector<int8_t> mSkills;
+  std::vector<int8_t> mCommited;
+  std::vector<int8_t> mModifiers;
+  std::vector<int8_t> mDifficulties;
+  std::vector<int8_t> mMargins;
+  std::vector<uint8_t> mSuccess;
+};
@@ -5,7 +5,7 @@
 class SkillCard: public Card
 {
 public:
-  SkillCard(const std::string& name, const Faction faction, const Skill& skill): Card{name, faction, skill} {}
+  SkillCard(const std::string_view name, const Faction faction, const Skill& skill): Card{name, faction, skill} {}
 
   friend bool operator==(const SkillCard& rhs, const SkillCard& lhs);
 
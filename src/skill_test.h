@@ -1,34 +1,116 @@
 #pragma once
 
+#include "card_db.h"
 #include "chaos_bag.h"
+#include "player.h"
+#include "token_table.h"
 
 #include <tuple>
+#include <type_traits>
 
+// Commited cards can be given either as cards (std::shared_ptr<Card>) or as ids of a CardDB card table. Ids are
+// only meaningful in the snapshot they were taken from, so they are always resolved from the snapshot the game or
+// the player holds, never from the current one
 template<typename T>
 struct SkillTest
 {
+  template<typename Cards = std::vector<std::shared_ptr<Card>>>
   std::pair<bool, int8_t> operator()(const Skill& skillTested,
                                      const Player& player,
                                      ChaosBag& chaosBag,
-                                     const std::vector<std::shared_ptr<Card>>& commitedCards)
+                                     const Cards& commitedCards)
   {
-    auto [token, effect] = chaosBag.GetToken();
+    static_assert(!kCommitsCardIds<Cards>, "Commited card ids need the snapshot they refer to");
+    return Perform(skillTested, player, chaosBag, commitedCards);
+  }
+
+  // Same test with the commited card ids resolved from snapshot
+  template<typename Cards = std::vector<CardId>>
+  std::pair<bool, int8_t> operator()(const Skill& skillTested,
+                                     const Player& player,
+                                     ChaosBag& chaosBag,
+                                     const Cards& commitedCards,
+                                     const CardDB::Snapshot& snapshot)
+  {
+    return Perform(skillTested, player, chaosBag, commitedCards, snapshot);
+  }
+
+  // Skill value of the player with the passive modifiers of its cards in play, plus the icons of the commited
+  // cards, before drawing any token
+  template<typename Cards = std::vector<std::shared_ptr<Card>>>
+  static int8_t GetSkillValue(const Player& player, const Cards& commitedCards)
+  {
+    static_assert(!kCommitsCardIds<Cards>, "Commited card ids need the snapshot they refer to");
+    return SumSkillValue(player, commitedCards);
+  }
+
+  template<typename Cards = std::vector<CardId>>
+  static int8_t GetSkillValue(const Player& player, const Cards& commitedCards, const CardDB::Snapshot& snapshot)
+  {
+    return SumSkillValue(player, commitedCards, snapshot);
+  }
+
+  // Icons a commited card adds to the test, ids are resolved from snapshot
+  template<typename CommitedCard, typename... Snapshot>
+  static int8_t GetCardValue(const CommitedCard& card, const Snapshot&... snapshot)
+  {
+    return T::GetSkillValue(GetCardSkill(card, snapshot...));
+  }
+
+  static int8_t GetDifficulty(const Skill& skillTested)
+  {
+    return T::GetSkillValue(skillTested) < 0 ? 0 : T::GetSkillValue(skillTested);
+  }
+
+private:
+  template<typename Cards>
+  static inline constexpr bool kCommitsCardIds = std::is_same_v<typename Cards::value_type, CardId>;
+
+  // Snapshot is empty when the commited cards are not ids
+  template<typename Cards, typename... Snapshot>
+  std::pair<bool, int8_t> Perform(const Skill& skillTested,
+                                  const Player& player,
+                                  ChaosBag& chaosBag,
+                                  const Cards& commitedCards,
+                                  const Snapshot&... snapshot)
+  {
+    const auto token = chaosBag.GetToken();
+    const auto& tokens = player.GetTokenTable();
 
     // Check autofail
-    if (token == ChaosToken::Token::kAutoFail)
+    if (tokens.Get(token.token).autoFail)
       return {false, 0};
 
     // Get result from the skill tested from the players and from the commited cards
-    auto result = T::GetSkillValue(player.GetSkill());
-    std::for_each(commitedCards.begin(),
-                  commitedCards.end(),
-                  [&result](const auto& card) { result += T::GetSkillValue(card->GetSkill()); });
-    auto comparisonValue = T::GetSkillValue(skillTested) < 0 ? 0 : T::GetSkillValue(skillTested);
+    auto result = SumSkillValue(player, commitedCards, snapshot...);
+    auto comparisonValue = GetDifficulty(skillTested);
 
-    // Add the effect of the token
-    result += effect;
+    // Add the effect of the token as the investigator and the scenario resolve it
+    result += tokens.template Resolve<T>(token);
 
     // Compare agains the skill
     return {result >= comparisonValue, result - comparisonValue};
   }
+
+  template<typename Cards, typename... Snapshot>
+  static int8_t SumSkillValue(const Player& player, const Cards& commitedCards, const Snapshot&... snapshot)
+  {
+    auto result = T::GetSkillValue(player.GetSkill());
+    result += T::GetSkillValue(player.GetSkillModifier());
+    std::for_each(commitedCards.begin(), commitedCards.end(), [&](const auto& card) {
+      result += T::GetSkillValue(GetCardSkill(card, snapshot...));
+    });
+    return result;
+  }
+
+  template<typename... Snapshot>
+  static const Skill& GetCardSkill(const std::shared_ptr<Card>& card, const Snapshot&...)
+  {
+    return card->GetSkill();
+  }
+
+  static const Skill& GetCardSkill(const CardId id, const CardDB::Snapshot& snapshot)
+  {
+    return snapshot.GetCardById(id)->GetSkill();
+  }
 };
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "skill_test.h"
+
+#include <map>
+
+struct SkillTestOdds
+{
+  double success{0.0};
+  double autoFail{0.0};
+  // Probability of each margin (result - difficulty), the autofail token is not part of it
+  std::map<int8_t, double> margins;
+};
+
+// Exact odds of a SkillTest<T>: instead of drawing a token it walks every distinct token of the bag weighted by
+// its count, applying the same rules as SkillTest::operator()
+template<typename T>
+struct SkillTestProbability
+{
+  template<typename Cards = std::vector<std::shared_ptr<Card>>>
+  SkillTestOdds operator()(const Skill& skillTested,
+                           const Player& player,
+                           const ChaosBagImpl& chaosBag,
+                           const Cards& commitedCards) const
+  {
+    return Get(SkillTest<T>::GetSkillValue(player, commitedCards),
+               SkillTest<T>::GetDifficulty(skillTested),
+               chaosBag.GetTokenCounts(),
+               player.GetTokenTable());
+  }
+
+  // Same odds with the commited card ids resolved from snapshot
+  template<typename Cards = std::vector<CardId>>
+  SkillTestOdds operator()(const Skill& skillTested,
+                           const Player& player,
+                           const ChaosBagImpl& chaosBag,
+                           const Cards& commitedCards,
+                           const CardDB::Snapshot& snapshot) const
+  {
+    return Get(SkillTest<T>::GetSkillValue(player, commitedCards, snapshot),
+               SkillTest<T>::GetDifficulty(skillTested),
+               chaosBag.GetTokenCounts(),
+               player.GetTokenTable());
+  }
+
+  static SkillTestOdds Get(const int8_t skillValue,
+                           const int8_t difficulty,
+                           const std::vector<ChaosBagImpl::TokenCount>& tokenCounts,
+                           const TokenTable& tokens = TokenTable::Default())
+  {
+    SkillTestOdds odds;
+    size_t total = 0;
+    std::for_each(tokenCounts.begin(),
+                  tokenCounts.end(),
+                  [&total](const auto& tokenCount) { total += tokenCount.count; });
+    if (total == 0)
+      return odds;
+
+    for (const auto& [token, count]: tokenCounts)
+    {
+      const double probability = static_cast<double>(count) / static_cast<double>(total);
+      if (tokens.Get(token.token).autoFail)
+      {
+        odds.autoFail += probability;
+        continue;
+      }
+
+      int8_t result = skillValue;
+      result += tokens.template Resolve<T>(token);
+      const int8_t margin = result - difficulty;
+      odds.margins[margin] += probability;
+      if (result >= difficulty)
+        odds.success += probability;
+    }
+    return odds;
+  }
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include "skill_test.h"
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <thread>
+#include <type_traits>
+
+struct SkillTestSimulation
+{
+  uint64_t trials{0};
+  uint64_t successes{0};
+  uint64_t autoFails{0};
+  // Number of trials that ended with each margin (result - difficulty), autofails are not part of it
+  std::map<int8_t, uint64_t> margins;
+
+  double GetSuccessRate() const
+  {
+    return trials == 0 ? 0.0 : static_cast<double>(successes) / static_cast<double>(trials);
+  }
+
+  // Wilson score interval of the success rate, z = 1.96 is the 95% interval
+  std::pair<double, double> GetConfidenceInterval(const double z = 1.96) const
+  {
+    if (trials == 0)
+      return {0.0, 1.0};
+    const double n = static_cast<double>(trials);
+    const double p = GetSuccessRate();
+    const double z2 = z * z;
+    const double center = (p + z2 / (2.0 * n)) / (1.0 + z2 / n);
+    const double halfWidth = z * std::sqrt(p * (1.0 - p) / n + z2 / (4.0 * n * n)) / (1.0 + z2 / n);
+    return {std::max(0.0, center - halfWidth), std::min(1.0, center + halfWidth)};
+  }
+
+  void Merge(const SkillTestSimulation& other)
+  {
+    trials += other.trials;
+    successes += other.successes;
+    autoFails += other.autoFails;
+    for (const auto& [margin, count]: other.margins)
+      margins[margin] += count;
+  }
+};
+
+// Runs SkillTest<T> many times over all the cores. Trials are split in fixed size chunks and every chunk draws
+// from its own Philox4x32 stream (master seed, chunk index), so the result only depends on the master seed and
+// the number of trials, never on the number of threads or on how the chunks were scheduled.
+template<typename T>
+class SkillTestSimulator
+{
+public:
+  static inline constexpr uint64_t kChunkSize = 1 << 14;
+
+  explicit SkillTestSimulator(const uint64_t masterSeed,
+                              const unsigned threads = std::max(1u, std::thread::hardware_concurrency())):
+    mMasterSeed{masterSeed},
+    mThreads{std::max(1u, threads)}
+  {}
+
+  template<typename Cards = std::vector<std::shared_ptr<Card>>>
+  SkillTestSimulation Run(const Skill& skillTested,
+                          const Player& player,
+                          const ChaosBagImpl& chaosBag,
+                          const Cards& commitedCards,
+                          const uint64_t trials) const
+  {
+    static_assert(!std::is_same_v<typename Cards::value_type, CardId>, "Commited card ids need their snapshot");
+    return Simulate(skillTested, player, chaosBag, commitedCards, trials);
+  }
+
+  // Same simulation with the commited card ids resolved from snapshot, every trial reads the same cards
+  template<typename Cards = std::vector<CardId>>
+  SkillTestSimulation Run(const Skill& skillTested,
+                          const Player& player,
+                          const ChaosBagImpl& chaosBag,
+                          const Cards& commitedCards,
+                          const CardDB::Snapshot& snapshot,
+                          const uint64_t trials) const
+  {
+    return Simulate(skillTested, player, chaosBag, commitedCards, trials, snapshot);
+  }
+
+private:
+  // Snapshot is empty when the commited cards are not ids
+  template<typename Cards, typename... Snapshot>
+  SkillTestSimulation Simulate(const Skill& skillTested,
+                               const Player& player,
+                               const ChaosBagImpl& chaosBag,
+                               const Cards& commitedCards,
+                               const uint64_t trials,
+                               const Snapshot&... snapshot) const
+  {
+    if (chaosBag.Size() == 0)
+      throw std::runtime_error("Cannot simulate a skill test with an empty chaos bag");
+
+    const uint64_t chunks = (trials + kChunkSize - 1) / kChunkSize;
+    const unsigned workers = static_cast<unsigned>(std::min<uint64_t>(mThreads, chunks));
+    std::vector<SkillTestSimulation> results(workers);
+    std::atomic<uint64_t> nextChunk{0};
+
+    auto worker = [&](SkillTestSimulation& result)
+    {
+      // Every worker owns its bag copy, only the token table is shared and it is never written
+      ChaosBagImpl bag{chaosBag};
+      SkillTest<T> skillTest;
+      std::array<uint64_t, 256> margins{};
+      for (uint64_t chunk = nextChunk++; chunk < chunks; chunk = nextChunk++)
+      {
+        bag.SetGenerator(Philox4x32{mMasterSeed, chunk});
+
+        const uint64_t chunkTrials = std::min(kChunkSize, trials - chunk * kChunkSize);
+        for (uint64_t i = 0; i < chunkTrials; ++i)
+        {
+          auto [succeed, margin] = skillTest(skillTested, player, bag, commitedCards, snapshot...);
+          // SkillTest reports the autofail as a failure with no margin, any other failure has a negative margin
+          if (!succeed && margin == 0)
+          {
+            ++result.autoFails;
+          }
+          else
+          {
+            result.successes += succeed;
+            ++margins[static_cast<uint8_t>(margin)];
+          }
+        }
+        result.trials += chunkTrials;
+      }
+
+      for (size_t i = 0; i < margins.size(); ++i)
+      {
+        if (margins[i] != 0)
+          result.margins[static_cast<int8_t>(i)] = margins[i];
+      }
+    };
+
+    {
+      std::vector<std::jthread> threads;
+      threads.reserve(workers);
+      for (unsigned i = 0; i < workers; ++i)
+        threads.emplace_back(worker, std::ref(results[i]));
+    }
+
+    SkillTestSimulation simulation;
+    std::for_each(results.begin(), results.end(), [&simulation](const auto& result) { simulation.Merge(result); });
+    return simulation;
+  }
+
+  uint64_t mMasterSeed;
+  unsigned mThreads;
+};
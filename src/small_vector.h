@@ -0,0 +1,264 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+// Vector that keeps its first N elements inside the object and only allocates when it grows past them. Meant for
+// the short lists cards have plenty of: most hold none or one element and never touch the heap
+template<typename T, size_t N>
+class SmallVector
+{
+public:
+  using value_type = T;
+  using iterator = T*;
+  using const_iterator = const T*;
+
+  SmallVector() noexcept = default;
+
+  SmallVector(std::initializer_list<T> values)
+  {
+    Reserve(values.size());
+    for (const auto& value: values)
+      push_back(value);
+  }
+
+  SmallVector(const SmallVector& other)
+  {
+    Reserve(other.mSize);
+    for (const auto& value: other)
+      push_back(value);
+  }
+
+  SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+  {
+    MoveFrom(std::move(other));
+  }
+
+  SmallVector& operator=(const SmallVector& other)
+  {
+    if (this != &other)
+    {
+      clear();
+      Reserve(other.mSize);
+      for (const auto& value: other)
+        push_back(value);
+    }
+    return *this;
+  }
+
+  SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+  {
+    if (this != &other)
+    {
+      Release();
+      MoveFrom(std::move(other));
+    }
+    return *this;
+  }
+
+  ~SmallVector()
+  {
+    Release();
+  }
+
+  template<typename... Args>
+  T& emplace_back(Args&&... args)
+  {
+    if (mSize == mCapacity)
+      return GrowAndEmplace(std::forward<Args>(args)...);
+    T* value = new (mData + mSize) T(std::forward<Args>(args)...);
+    ++mSize;
+    return *value;
+  }
+
+  void push_back(const T& value)
+  {
+    emplace_back(value);
+  }
+
+  void push_back(T&& value)
+  {
+    emplace_back(std::move(value));
+  }
+
+  void clear() noexcept
+  {
+    std::destroy(begin(), end());
+    mSize = 0;
+  }
+
+  size_t size() const noexcept
+  {
+    return mSize;
+  }
+
+  bool empty() const noexcept
+  {
+    return mSize == 0;
+  }
+
+  // True while the elements still live inside the object
+  bool IsInline() const noexcept
+  {
+    return mData == InlineData();
+  }
+
+  T& operator[](const size_t index)
+  {
+    return mData[index];
+  }
+
+  const T& operator[](const size_t index) const
+  {
+    return mData[index];
+  }
+
+  T& at(const size_t index)
+  {
+    if (index >= mSize)
+      throw std::out_of_range("SmallVector index out of range");
+    return mData[index];
+  }
+
+  const T& at(const size_t index) const
+  {
+    if (index >= mSize)
+      throw std::out_of_range("SmallVector index out of range");
+    return mData[index];
+  }
+
+  iterator begin() noexcept
+  {
+    return mData;
+  }
+
+  iterator end() noexcept
+  {
+    return mData + mSize;
+  }
+
+  const_iterator begin() const noexcept
+  {
+    return mData;
+  }
+
+  const_iterator end() const noexcept
+  {
+    return mData + mSize;
+  }
+
+  friend bool operator==(const SmallVector& lhs, const SmallVector& rhs)
+  {
+    return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+  }
+
+private:
+  T* InlineData() noexcept
+  {
+    return std::launder(reinterpret_cast<T*>(mInline));
+  }
+
+  const T* InlineData() const noexcept
+  {
+    return std::launder(reinterpret_cast<const T*>(mInline));
+  }
+
+  static T* Allocate(const size_t capacity)
+  {
+    return static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t{alignof(T)}));
+  }
+
+  static void Deallocate(T* data) noexcept
+  {
+    ::operator delete(data, std::align_val_t{alignof(T)});
+  }
+
+  void Reserve(const size_t capacity)
+  {
+    if (capacity <= mCapacity)
+      return;
+
+    auto* data = Allocate(capacity);
+    try
+    {
+      std::uninitialized_move(begin(), end(), data);
+    }
+    catch (...)
+    {
+      Deallocate(data);
+      throw;
+    }
+    Adopt(data, capacity);
+  }
+
+  // The new element is built in the new block before the others move there, the arguments may refer to one of
+  // them (v.push_back(v[0]))
+  template<typename... Args>
+  T& GrowAndEmplace(Args&&... args)
+  {
+    const auto capacity = std::max<size_t>(mCapacity * 2, 1);
+    auto* data = Allocate(capacity);
+    T* value = nullptr;
+    try
+    {
+      value = new (data + mSize) T(std::forward<Args>(args)...);
+      std::uninitialized_move(begin(), end(), data);
+    }
+    catch (...)
+    {
+      if (value != nullptr)
+        std::destroy_at(value);
+      Deallocate(data);
+      throw;
+    }
+    Adopt(data, capacity);
+    ++mSize;
+    return *value;
+  }
+
+  // Takes the block the elements were moved to, the moved from ones are destroyed with the old block
+  void Adopt(T* data, const size_t capacity) noexcept
+  {
+    const auto size = mSize;
+    Release();
+    mData = data;
+    mSize = size;
+    mCapacity = capacity;
+  }
+
+  // Destroys the elements and frees the heap block, leaving the vector empty and inline
+  void Release() noexcept
+  {
+    clear();
+    if (!IsInline())
+      Deallocate(mData);
+    mData = InlineData();
+    mCapacity = N;
+  }
+
+  void MoveFrom(SmallVector&& other)
+  {
+    if (other.IsInline())
+    {
+      std::uninitialized_move(other.begin(), other.end(), mData);
+      mSize = other.mSize;
+      other.clear();
+      return;
+    }
+
+    // The heap block changes hands, the elements stay where they are
+    mData = std::exchange(other.mData, other.InlineData());
+    mSize = std::exchange(other.mSize, 0);
+    mCapacity = std::exchange(other.mCapacity, N);
+  }
+
+  alignas(T) std::byte mInline[N * sizeof(T)];
+  T* mData{InlineData()};
+  size_t mSize{0};
+  size_t mCapacity{N};
+};
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+// 32-bit handle of an interned string, equal strings share the same handle
+using NameHandle = uint32_t;
+static inline constexpr NameHandle kInvalidNameHandle = UINT32_MAX;
+
+// Global pool of card names, cards keep the 32-bit handle of their name instead of a string. Any thread may intern,
+// CardDB sections load on whichever thread needs them first. Only Intern takes the lock: strings are stored in
+// blocks that never move and a string is published by the release store of the size, so Get is two loads
+class StringInterner
+{
+public:
+  static inline StringInterner& Instance()
+  {
+    static StringInterner instance;
+    return instance;
+  }
+
+  NameHandle Intern(const std::string_view value)
+  {
+    const std::lock_guard lock{mMutex};
+    if (const auto it = mHandles.find(value); it != mHandles.end())
+      return it->second;
+
+    const auto handle = static_cast<NameHandle>(mSize.load(std::memory_order_relaxed));
+    if (handle == kInvalidNameHandle)
+      throw std::length_error("String interner is full");
+
+    const auto [block, offset] = Locate(handle);
+    if (offset == 0)
+      mBlocks[block] = std::make_unique<std::string[]>(kFirstBlockSize << block);
+    auto& stored = mBlocks[block][offset];
+    stored = value;
+    mHandles.insert({stored, handle});
+    mSize.store(handle + 1, std::memory_order_release);
+    return handle;
+  }
+
+  // The view stays valid for the life of the process, interned strings never move
+  std::string_view Get(const NameHandle handle) const
+  {
+    if (handle >= mSize.load(std::memory_order_acquire))
+      throw std::out_of_range("Name handle was never interned");
+    const auto [block, offset] = Locate(handle);
+    return mBlocks[block][offset];
+  }
+
+  size_t Size() const
+  {
+    return mSize.load(std::memory_order_acquire);
+  }
+
+private:
+  StringInterner() = default;
+
+  // Block k holds kFirstBlockSize << k strings, so 27 blocks cover every handle
+  static inline constexpr size_t kFirstBlockBits = 6;
+  static inline constexpr size_t kFirstBlockSize = size_t{1} << kFirstBlockBits;
+  static inline constexpr size_t kBlockCount = 33 - kFirstBlockBits;
+
+  static std::pair<size_t, size_t> Locate(const NameHandle handle)
+  {
+    const auto position = static_cast<uint64_t>(handle) + kFirstBlockSize;
+    const auto block = static_cast<size_t>(std::bit_width(position)) - 1 - kFirstBlockBits;
+    return {block, static_cast<size_t>(position - (kFirstBlockSize << block))};
+  }
+
+  // Written under mMutex before the size that makes them visible, readers only touch published strings
+  std::array<std::unique_ptr<std::string[]>, kBlockCount> mBlocks;
+  std::atomic<size_t> mSize{0};
+  std::unordered_map<std::string_view, NameHandle> mHandles;
+  std::mutex mMutex;
+};
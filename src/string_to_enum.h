@@ -1,126 +1,154 @@
 #pragma once
 
+#include "chaos_token.h"
+#include "perfect_hash.h"
+
 #include <array>
-#include <string>
+#include <bit>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
 
 enum class Faction : uint8_t;
 enum class Slot : uint8_t;
 enum class LocationOptionalEffectCondition : uint8_t;
+enum class EffectType;
 enum class EffectModifications
 {
   kDamage,
   kShroud,
   kInvalid
 };
-class StringToEnum
+
+// Names of the values of an enum in enumerator order, with a perfect hash of them found at compile time: looking
+// up a name is one hash and one comparison, and nothing is allocated either way
+template<size_t Size>
+class EnumNameTable
 {
 public:
-  template<typename T>
-  static inline T Get(const std::string& name)
+  consteval EnumNameTable(const std::array<std::string_view, Size>& names, const std::string_view typeName):
+    mNames{names},
+    mTypeName{typeName}
   {
-    return T::kInvalid;
+    for (;; ++mSeed)
+    {
+      if (mSeed == kMaxSeed)
+        throw std::logic_error("No perfect hash for the enum names");
+
+      mSlots.fill(kEmptySlot);
+      size_t placed = 0;
+      for (; placed < Size; ++placed)
+      {
+        auto& slot = mSlots[PerfectHash::Hash(mNames[placed], mSeed) % kSlotCount];
+        if (slot != kEmptySlot)
+          break;
+        slot = static_cast<uint8_t>(placed);
+      }
+      if (placed == Size)
+        return;
+    }
   }
 
-  template<typename T>
-  static inline std::string GetString(const T value)
+  constexpr std::optional<size_t> Find(const std::string_view name) const
   {
-    return "invalid";
+    const auto index = mSlots[PerfectHash::Hash(name, mSeed) % kSlotCount];
+    if (index == kEmptySlot || mNames[index] != name)
+      return std::nullopt;
+    return index;
   }
 
-  template<>
-  static inline Slot Get(const std::string& name)
+  constexpr std::string_view GetName(const size_t index) const
   {
-    return Get<Slot, kSlotSize>(name, kSlotNames);
+    return index < Size ? mNames[index] : "invalid";
   }
 
-  template<>
-  static inline std::string GetString(const Slot value)
+  constexpr std::string_view GetTypeName() const
   {
-    return GetString<Slot, kSlotSize>(value, kSlotNames);
+    return mTypeName;
   }
 
-  template<>
-  static inline Faction Get(const std::string& name)
-  {
-    return Get<Faction, kFactionSize>(name, kFactionNames);
-  }
+private:
+  static inline constexpr uint8_t kEmptySlot = UINT8_MAX;
+  // Twice as many slots as names, a seed that spreads them is found after a few tries
+  static inline constexpr size_t kSlotCount = std::bit_ceil(2 * Size);
+  static inline constexpr uint64_t kMaxSeed = 1u << 16;
+
+  std::array<std::string_view, Size> mNames;
+  std::string_view mTypeName;
+  std::array<uint8_t, kSlotCount> mSlots{};
+  uint64_t mSeed{0};
+};
 
-  template<>
-  static inline std::string GetString(const Faction value)
-  {
-    return GetString<Faction, kFactionSize>(value, kFactionNames);
-  }
+// Names of every enum StringToEnum knows, in enumerator order
+template<typename T>
+struct EnumNames;
 
-  template<>
-  static inline LocationOptionalEffectCondition Get(const std::string& name)
-  {
-    return Get<LocationOptionalEffectCondition, kLocationOptionalEffectConditionSize>(
-      name,
-      kLocationOptionalEffectConditionNames);
-  }
+template<>
+struct EnumNames<Faction>
+{
+  static inline constexpr EnumNameTable<6> kTable{
+    {"guardian", "seeker", "rogue", "mystic", "survivor", "neutral"}, "Faction"};
+};
 
-  template<>
-  static inline std::string GetString(const LocationOptionalEffectCondition value)
-  {
-    return GetString<LocationOptionalEffectCondition, kLocationOptionalEffectConditionSize>(
-      value,
-      kLocationOptionalEffectConditionNames);
-  }
+template<>
+struct EnumNames<Slot>
+{
+  static inline constexpr EnumNameTable<5> kTable{{"accessory", "body", "ally", "hand", "arcane"}, "Slot"};
+};
 
-private:
-  static inline constexpr uint8_t kFactionSize = 6;
-  static inline const std::array<std::string, static_cast<size_t>(kFactionSize)> kFactionNames =
-    {"guardian", "seeker", "rogue", "mystic", "survivor", "neutral"};
-  static inline constexpr uint8_t kSlotSize = 5;
-  static inline const std::array<std::string, static_cast<size_t>(kSlotSize)> kSlotNames = {"accessory",
-                                                                                            "body",
-                                                                                            "ally",
-                                                                                            "hand",
-                                                                                            "arcane"};
-  static inline constexpr uint8_t kLocationOptionalEffectConditionSize = 1;
-  static inline const std::array<std::string, static_cast<size_t>(kLocationOptionalEffectConditionSize)>
-    kLocationOptionalEffectConditionNames = {"undiscovered_clues"};
+template<>
+struct EnumNames<LocationOptionalEffectCondition>
+{
+  static inline constexpr EnumNameTable<1> kTable{{"undiscovered_clues"}, "LocationOptionalEffectCondition"};
+};
 
-  template<typename T>
-  static inline std::string GetTypeName()
-  {
-    return typeid(T).name();
-  }
+template<>
+struct EnumNames<EffectType>
+{
+  static inline constexpr EnumNameTable<4> kTable{{"activate", "trigger", "pasive", "discard"}, "EffectType"};
+};
 
-  template<>
-  static inline std::string GetTypeName<Faction>()
-  {
-    return "Faction";
-  }
+template<>
+struct EnumNames<ChaosToken::Token>
+{
+  static inline constexpr EnumNameTable<7> kTable{
+    {"skull", "cultist", "tablet", "elder_thing", "elder_sign", "auto_fail", "value"}, "ChaosToken"};
+};
 
-  template<>
-  static inline std::string GetTypeName<Slot>()
-  {
-    return "Slot";
-  }
+template<>
+struct EnumNames<EffectModifications>
+{
+  static inline constexpr EnumNameTable<2> kTable{{"damage", "shroud"}, "EffectModifications"};
+};
 
-  template<>
-  static inline std::string GetTypeName<LocationOptionalEffectCondition>()
+class StringToEnum
+{
+public:
+  template<typename T>
+  static inline T Get(const std::string_view name)
   {
-    return "LocationOptionalEffectCondition";
+    const auto value = TryGet<T>(name);
+    if (!value.has_value())
+    {
+      throw std::runtime_error(
+        fmt::format("'{}' is not registered as {}", name, EnumNames<T>::kTable.GetTypeName()));
+    }
+    return value.value();
   }
 
-  template<typename T, int Size>
-  static inline T Get(const std::string& name, const std::array<std::string, Size>& nameList)
+  template<typename T>
+  static inline constexpr std::optional<T> TryGet(const std::string_view name)
   {
-    auto it = std::find(nameList.begin(), nameList.end(), name);
-    if (it == nameList.end())
-    {
-      throw std::runtime_error(fmt::format("'{}' is not registered as {}", name, GetTypeName<T>()));
-    }
-    auto d = std::distance(nameList.begin(), it);
-    return static_cast<T>(d);
+    const auto index = EnumNames<T>::kTable.Find(name);
+    if (!index.has_value())
+      return std::nullopt;
+    return static_cast<T>(index.value());
   }
 
-  template<typename T, int Size>
-  static inline std::string GetString(const T value, const std::array<std::string, Size>& nameList)
+  // Name of the value, "invalid" for kInvalid. The view points to static storage
+  template<typename T>
+  static inline constexpr std::string_view GetString(const T value)
   {
-    size_t idx = static_cast<typename std::underlying_type<T>::type>(value);
-    return nameList.at(idx);
+    return EnumNames<T>::kTable.GetName(static_cast<size_t>(value));
   }
-};
\ No newline at end of file
+};
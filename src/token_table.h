@@ -0,0 +1,93 @@
+#pragma once
+
+#include "chaos_token.h"
+#include "effect.h"
+#include "investigator.h"
+#include "skill.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <variant>
+
+// Modifiers a scenario gives its symbol tokens, resolved when the scenario loads. A token without one keeps the
+// value it has in the chaos bag
+using ScenarioTokens = std::array<std::optional<int8_t>, static_cast<size_t>(ChaosToken::Token::kInvalid)>;
+
+// How a token kind resolves in a skill test:
+//   modifier = modifiers[skill] + token.effect * passThrough
+// with one modifier per skill, in the order of Willpower/Intellect/Combat/Agility::kIndex
+struct TokenResolution
+{
+  std::array<int8_t, 4> modifiers{};
+  int8_t passThrough{1};
+  bool autoFail{false};
+};
+
+// Resolution of every token kind for one investigator in one scenario. It is built when the scenario loads, so
+// resolving a drawn token in a skill test is an array lookup and one multiply-add whatever its kind
+class TokenTable
+{
+public:
+  static inline constexpr size_t kTokens = static_cast<size_t>(ChaosToken::Token::kInvalid) + 1;
+
+  // Every token counts its own value except the autofail, which is how SkillTest resolved them before
+  TokenTable()
+  {
+    mResolutions[static_cast<size_t>(ChaosToken::Token::kAutoFail)].autoFail = true;
+  }
+
+  static const TokenTable& Default()
+  {
+    static const TokenTable table;
+    return table;
+  }
+
+  static TokenTable Build(const Investigator& investigator, const ScenarioTokens& scenario = {})
+  {
+    TokenTable table;
+    for (size_t token = 0; token < scenario.size(); ++token)
+    {
+      if (!scenario[token].has_value() || token == static_cast<size_t>(ChaosToken::Token::kAutoFail))
+        continue;
+
+      auto& resolution = table.mResolutions[token];
+      resolution.modifiers.fill(scenario[token].value());
+      resolution.passThrough = 0;
+    }
+
+    // Only the modifier of the elder sign ability is resolved, its other effects need game state
+    auto& elderSign = table.mResolutions[static_cast<size_t>(ChaosToken::Token::kElderSign)];
+    if (const auto& effect = investigator.GetElderSign(); effect.has_value())
+    {
+      const Skill skill = std::visit([](const Effect& alternative) { return alternative.GetSkill(); }, *effect);
+      elderSign.modifiers[Willpower::kIndex] += Willpower::GetSkillValue(skill);
+      elderSign.modifiers[Intellect::kIndex] += Intellect::GetSkillValue(skill);
+      elderSign.modifiers[Combat::kIndex] += Combat::GetSkillValue(skill);
+      elderSign.modifiers[Agility::kIndex] += Agility::GetSkillValue(skill);
+    }
+    return table;
+  }
+
+  const TokenResolution& Get(const ChaosToken::Token token) const
+  {
+    return mResolutions[std::min(static_cast<size_t>(token), kTokens - 1)];
+  }
+
+  void Set(const ChaosToken::Token token, const TokenResolution& resolution)
+  {
+    mResolutions[std::min(static_cast<size_t>(token), kTokens - 1)] = resolution;
+  }
+
+  // Modifier of the token in a SkillTest<T>, autofails are checked apart with Get(token).autoFail
+  template<typename T>
+  int8_t Resolve(const ChaosToken& token) const
+  {
+    const auto& resolution = Get(token.token);
+    return static_cast<int8_t>(resolution.modifiers[T::kIndex] + token.effect * resolution.passThrough);
+  }
+
+private:
+  std::array<TokenResolution, kTokens> mResolutions;
+};
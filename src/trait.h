@@ -0,0 +1,179 @@
+#pragma once
+
+#include "spdlog/spdlog.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#if !defined(ARKHAM_DISABLE_SIMD)
+#if defined(__AVX2__)
+#define ARKHAM_TRAIT_MASK_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ARKHAM_TRAIT_MASK_SSE2
+#include <emmintrin.h>
+#endif
+#endif
+
+using TraitId = uint8_t;
+
+// Set of traits, one bit per TraitId. Checking a trait or a set of traits is a few AND of the four words, a single
+// vptest with AVX2
+class TraitMask
+{
+public:
+  static inline constexpr size_t kMaxTraits = 256;
+
+  TraitMask() = default;
+
+  void Set(const TraitId trait)
+  {
+    mWords[trait / 64] |= uint64_t{1} << (trait % 64);
+  }
+
+  bool Has(const TraitId trait) const
+  {
+    return (mWords[trait / 64] >> (trait % 64)) & 1;
+  }
+
+  // Every trait of required is in this mask
+  bool HasAll(const TraitMask& required) const
+  {
+#if defined(ARKHAM_TRAIT_MASK_AVX2)
+    const __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(mWords.data()));
+    return _mm256_testc_si256(mask, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(required.mWords.data())));
+#elif defined(ARKHAM_TRAIT_MASK_SSE2)
+    auto contains = [this, &required](const size_t word)
+    {
+      const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(mWords.data() + word));
+      const __m128i other = _mm_loadu_si128(reinterpret_cast<const __m128i*>(required.mWords.data() + word));
+      return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(mask, other), other)) == 0xffff;
+    };
+    return contains(0) && contains(2);
+#else
+    return (mWords[0] & required.mWords[0]) == required.mWords[0]
+           && (mWords[1] & required.mWords[1]) == required.mWords[1]
+           && (mWords[2] & required.mWords[2]) == required.mWords[2]
+           && (mWords[3] & required.mWords[3]) == required.mWords[3];
+#endif
+  }
+
+  // At least one trait of other is in this mask
+  bool HasAny(const TraitMask& other) const
+  {
+    return ((mWords[0] & other.mWords[0]) | (mWords[1] & other.mWords[1]) | (mWords[2] & other.mWords[2])
+            | (mWords[3] & other.mWords[3]))
+           != 0;
+  }
+
+  bool Empty() const
+  {
+    return (mWords[0] | mWords[1] | mWords[2] | mWords[3]) == 0;
+  }
+
+  bool operator==(const TraitMask&) const = default;
+
+private:
+  std::array<uint64_t, 4> mWords{};
+};
+
+static_assert(sizeof(TraitMask) * 8 == TraitMask::kMaxTraits);
+
+// Every trait seen in the card data, each one gets the next TraitId the first time it is read. Thread safe, card
+// sections are loaded on whichever thread needs them first
+class TraitRegistry
+{
+public:
+  static inline TraitRegistry& Instance()
+  {
+    static TraitRegistry instance;
+    return instance;
+  }
+
+  TraitId Register(const std::string_view name)
+  {
+    const std::unique_lock lock{mMutex};
+    if (const auto it = mIds.find(name); it != mIds.end())
+      return it->second;
+    if (mNames.size() == TraitMask::kMaxTraits)
+      throw std::runtime_error(fmt::format("Can not register trait '{}', there are already {} traits",
+                                           name,
+                                           TraitMask::kMaxTraits));
+
+    const auto id = static_cast<TraitId>(mNames.size());
+    // A deque never moves its elements, the map keys stay valid
+    mIds.insert({mNames.emplace_back(name), id});
+    return id;
+  }
+
+  std::optional<TraitId> Find(const std::string_view name) const
+  {
+    const std::shared_lock lock{mMutex};
+    const auto it = mIds.find(name);
+    return it == mIds.end() ? std::nullopt : std::optional<TraitId>{it->second};
+  }
+
+  std::string_view GetName(const TraitId trait) const
+  {
+    const std::shared_lock lock{mMutex};
+    return mNames.at(trait);
+  }
+
+  // Mask of a trait line of the card data ("Item. Weapon. Melee."), registering the traits not seen yet
+  TraitMask Parse(const std::string_view traits)
+  {
+    TraitMask mask;
+    size_t begin = 0;
+    while (begin < traits.size())
+    {
+      const size_t end = std::min(traits.find('.', begin), traits.size());
+      auto trait = traits.substr(begin, end - begin);
+      while (!trait.empty() && trait.front() == ' ')
+        trait.remove_prefix(1);
+      while (!trait.empty() && trait.back() == ' ')
+        trait.remove_suffix(1);
+      if (!trait.empty())
+        mask.Set(Register(trait));
+      begin = end + 1;
+    }
+    return mask;
+  }
+
+  // Back to the card data form, traits in TraitId order
+  std::string Format(const TraitMask& mask) const
+  {
+    std::string traits;
+    const std::shared_lock lock{mMutex};
+    for (size_t trait = 0; trait < mNames.size(); ++trait)
+    {
+      if (mask.Has(static_cast<TraitId>(trait)))
+        traits += fmt::format("{}{}.", traits.empty() ? "" : " ", mNames[trait]);
+    }
+    return traits;
+  }
+
+private:
+  TraitRegistry() = default;
+
+  std::deque<std::string> mNames;
+  std::unordered_map<std::string_view, TraitId> mIds;
+  mutable std::shared_mutex mMutex;
+};
+
+template<>
+struct fmt::formatter<TraitMask>: fmt::formatter<std::string>
+{
+  auto format(const TraitMask& traits, format_context& ctx) const -> decltype(ctx.out())
+  {
+    return fmt::format_to(ctx.out(), "{}", TraitRegistry::Instance().Format(traits));
+  }
+};
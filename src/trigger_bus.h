@@ -0,0 +1,143 @@
+#pragma once
+
+#include "card.h"
+#include "card_id.h"
+#include "effect.h"
+#include "small_vector.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Game events trigger effects react to
+enum class GameEvent : uint8_t
+{
+  kSkillTest,
+  kFight,
+  kInvestigate,
+  kEnemyAttack,
+  kInvalid
+};
+
+// What a triggered effect acts on
+enum class TriggerTarget : uint8_t
+{
+  kNone,
+  kAttackingEnemy,
+  kInvalid
+};
+
+struct TriggerKey
+{
+  GameEvent event{GameEvent::kInvalid};
+  TriggerTarget target{TriggerTarget::kInvalid};
+};
+
+// Event and target that fire a trigger effect. kInvalid for effects no event fires, they are not subscribed
+inline TriggerKey GetTriggerKey(const EffectVariant& effect)
+{
+  struct Visitor
+  {
+    TriggerKey operator()(const Effect&) const
+    {
+      return {GameEvent::kSkillTest, TriggerTarget::kNone};
+    }
+    TriggerKey operator()(const FightEffectWithAdditionalDamage&) const
+    {
+      return {GameEvent::kFight, TriggerTarget::kNone};
+    }
+    TriggerKey operator()(const InvestigateEffectWithShroudModification&) const
+    {
+      return {GameEvent::kInvestigate, TriggerTarget::kNone};
+    }
+    TriggerKey operator()(const MakeDamageToAttacker&) const
+    {
+      return {GameEvent::kEnemyAttack, TriggerTarget::kAttackingEnemy};
+    }
+    TriggerKey operator()(const MakeDamageAtTargetAtCurrentLocation&) const
+    {
+      return {};
+    }
+  };
+  // The fight effects with conditions or optional skills derive from FightEffectWithAdditionalDamage and take
+  // its overload
+  return std::visit(Visitor{}, effect);
+}
+
+// Trigger effects of the cards in play, indexed by the event and target that fire them. A card subscribes its
+// trigger effects when it enters play and unsubscribes them when it leaves, so firing an event only visits the
+// effects waiting for it. The bus points into the cards, they must outlive their subscription
+class TriggerBus
+{
+public:
+  struct Handler
+  {
+    CardInPlayId owner;
+    const EffectVariant* effect;
+  };
+
+  // Replaces the effects the owner had subscribed, a card subscribed twice still fires once
+  void Subscribe(const CardInPlayId owner, const Card& card)
+  {
+    Unsubscribe(owner);
+    auto& buckets = mOwnerBuckets[owner];
+    for (const auto& effect: card.GetTriggerEffect())
+    {
+      const auto key = GetTriggerKey(effect);
+      if (key.event == GameEvent::kInvalid)
+        continue;
+
+      const auto bucket = GetBucket(key);
+      mHandlers[bucket].push_back({owner, &effect});
+      if (std::find(buckets.begin(), buckets.end(), bucket) == buckets.end())
+        buckets.push_back(bucket);
+    }
+  }
+
+  // Only the buckets the owner subscribed to are touched
+  void Unsubscribe(const CardInPlayId owner)
+  {
+    const auto it = mOwnerBuckets.find(owner);
+    if (it == mOwnerBuckets.end())
+      return;
+
+    for (const auto bucket: it->second)
+      std::erase_if(mHandlers[bucket], [owner](const Handler& handler) { return handler.owner == owner; });
+    mOwnerBuckets.erase(it);
+  }
+
+  // Calls function(owner, effect) for every subscribed effect, in subscription order. Returns how many it called
+  template<typename Function>
+  size_t Fire(const GameEvent event, const TriggerTarget target, Function&& function) const
+  {
+    if (event == GameEvent::kInvalid || target == TriggerTarget::kInvalid)
+      return 0;
+
+    const auto& handlers = mHandlers[GetBucket({event, target})];
+    for (const auto& handler: handlers)
+      function(handler.owner, *handler.effect);
+    return handlers.size();
+  }
+
+  size_t GetSubscriberCount(const GameEvent event, const TriggerTarget target) const
+  {
+    if (event == GameEvent::kInvalid || target == TriggerTarget::kInvalid)
+      return 0;
+    return mHandlers[GetBucket({event, target})].size();
+  }
+
+private:
+  static inline constexpr size_t kEvents = static_cast<size_t>(GameEvent::kInvalid);
+  static inline constexpr size_t kTargets = static_cast<size_t>(TriggerTarget::kInvalid);
+
+  static uint8_t GetBucket(const TriggerKey& key)
+  {
+    return static_cast<uint8_t>(static_cast<size_t>(key.event) * kTargets + static_cast<size_t>(key.target));
+  }
+
+  std::array<std::vector<Handler>, kEvents * kTargets> mHandlers;
+  // Buckets each owner has handlers in, a card rarely reacts to more than a couple of events
+  std::unordered_map<CardInPlayId, SmallVector<uint8_t, 2>> mOwnerBuckets;
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "condition_evaluator.h"
+
+#include <gmock/gmock.h>
+
+class Mock_ConditionState: public ConditionState
+{
+public:
+  MOCK_METHOD(CardInPlayId, GetActingInvestigator, (), (const override));
+  MOCK_METHOD(CardInPlayId, GetActingLocation, (), (const override));
+  MOCK_METHOD(bool, IsEnemyEngaged, (), (const override));
+  MOCK_METHOD(uint8_t, GetUndiscoveredClues, (), (const override));
+  MOCK_METHOD(uint64_t, GetEngagementEpoch, (), (const override));
+  MOCK_METHOD(uint64_t, GetCluesEpoch, (), (const override));
+};
@@ -8,7 +8,12 @@ class Mock_Player: public Player
 {
 public:
   MOCK_METHOD(const Skill&, GetSkill, (), (const override));
+  MOCK_METHOD(Skill, GetSkillModifier, (), (const override));
+  MOCK_METHOD(SkillAggregate&, GetPassives, (), (override));
+  MOCK_METHOD(const TokenTable&, GetTokenTable, (), (const override));
+  MOCK_METHOD(void, LoadScenario, (const ScenarioTokens&), (override));
   MOCK_METHOD(uint8_t, GetDamagePool, (), (const override));
   MOCK_METHOD(uint8_t, GetHorrorPool, (), (const override));
   MOCK_METHOD(void, DrawCard, (), (override));
+  MOCK_METHOD(void, SetGenerator, (const Philox4x32&), (override));
 };
\ No newline at end of file
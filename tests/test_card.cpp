@@ -1,7 +1,20 @@
+#include "arkhamdb_reader.h"
+#include "card_db_reader.h"
 #include "card_factory.h"
+#include "card_image.h"
+#include "embedded_cards.h"
+#include "perfect_hash.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#ifdef ARKHAM_EMBEDDED_CARDS
+#include "embedded_card_data.h"
+#endif
+
 using namespace ::testing;
 
 TEST(CardFactory, CreateExistingInvestigatorCard)
@@ -50,15 +63,12 @@ TEST(CardFactory, CheckExistingAssetCard_Rolands38Special)
   activationOpionalEffectSkill.combat = 3;
 
   Asset expectedCard{"Roland's .38 Special", Faction::kNeutral, cardSkill, cost, Slot::kHand, uses};
-  std::shared_ptr<Effect> activationEffect = std::make_shared<LocationOptionalFightEffectWithAdditionalDamage>(
-    activationEffectSkill,
-    activationCost,
-    additionalDamage,
-    LocationOptionalEffect{activationEffectSkill,
-                           activationCost,
-                           activationOpionalEffectSkill,
-                           LocationOptionalEffectCondition::kUndiscoveredClues});
-  expectedCard.RegisterActivationEffect(activationEffect);
+  const LocationOptionalEffect locationOptionalEffect{activationEffectSkill,
+                                                      activationCost,
+                                                      activationOpionalEffectSkill,
+                                                      LocationOptionalEffectCondition::kUndiscoveredClues};
+  expectedCard.RegisterActivationEffect(LocationOptionalFightEffectWithAdditionalDamage{
+    activationEffectSkill, activationCost, additionalDamage, locationOptionalEffect});
   EXPECT_EQ(*card, expectedCard);
 }
 
@@ -77,9 +87,8 @@ TEST(CardFactory, CheckExistingAssetCard_45Automatic)
   activationEffectSkill.combat = 1;
 
   Asset expectedCard{".45 Automatic", Faction::kGuardian, cardSkill, cost, Slot::kHand, uses};
-  std::shared_ptr<Effect> activationEffect =
-    std::make_shared<FightEffectWithAdditionalDamage>(activationEffectSkill, activationCost, additionalDamage);
-  expectedCard.RegisterActivationEffect(activationEffect);
+  expectedCard.RegisterActivationEffect(
+    FightEffectWithAdditionalDamage{activationEffectSkill, activationCost, additionalDamage});
   EXPECT_EQ(*card, expectedCard);
 }
 
@@ -101,10 +110,8 @@ TEST(CardFactory, CheckExistingAssetCard_PhysicalTraining)
   triggerEffectSkillCombat.combat = 1;
 
   Asset expectedCard{"Physical Training", Faction::kGuardian, cardSkill, cost, Slot::kInvalid};
-  auto triggerEffectWillpower = std::make_shared<Effect>(triggerEffectSkillWillpower, activationCost);
-  auto triggerEffectCombat = std::make_shared<Effect>(triggerEffectSkillCombat, activationCost);
-  expectedCard.RegisterTriggerEffect(triggerEffectWillpower);
-  expectedCard.RegisterTriggerEffect(triggerEffectCombat);
+  expectedCard.RegisterTriggerEffect(Effect{triggerEffectSkillWillpower, activationCost});
+  expectedCard.RegisterTriggerEffect(Effect{triggerEffectSkillCombat, activationCost});
   EXPECT_EQ(*card, expectedCard);
 }
 
@@ -119,9 +126,7 @@ TEST(CardFactory, CheckExistingAssetCard_Flashlight)
   cardSkill.intellect = 1;
 
   Asset expectedCard{"Flashlight", Faction::kNeutral, cardSkill, cost, Slot::kHand, uses};
-  std::shared_ptr<Effect> activationEffect =
-    std::make_shared<InvestigateEffectWithShroudModification>(Skill{}, activationCost, -2);
-  expectedCard.RegisterActivationEffect(activationEffect);
+  expectedCard.RegisterActivationEffect(InvestigateEffectWithShroudModification{Skill{}, activationCost, -2});
   EXPECT_EQ(*card, expectedCard);
 }
 
@@ -136,10 +141,8 @@ TEST(CardFactory, CheckExistingAssetCard_BeatCop)
   cardSkill.combat = 1;
 
   Asset expectedCard{"Beat Cop", Faction::kGuardian, cardSkill, cost, Slot::kAlly, std::nullopt, health, sanity};
-  std::shared_ptr<Effect> pasiveEffect = std::make_shared<Effect>(Skill{0, 0, 1, 0}, 0);
-  expectedCard.RegisterPasiveEffect(pasiveEffect);
-  std::shared_ptr<Effect> discardEffect = std::make_shared<MakeDamageAtTargetAtCurrentLocation>(Skill{}, 0, 1);
-  expectedCard.RegisterDiscardEffect(discardEffect);
+  expectedCard.RegisterPasiveEffect(Effect{Skill{0, 0, 1, 0}, 0});
+  expectedCard.RegisterDiscardEffect(MakeDamageAtTargetAtCurrentLocation{Skill{}, 0, 1});
   EXPECT_EQ(*card, expectedCard);
 }
 
@@ -152,12 +155,8 @@ TEST(CardFactory, CheckExistingAssetCard_Machete)
   cardSkill.combat = 1;
 
   Asset expectedCard{"Machete", Faction::kGuardian, cardSkill, cost, Slot::kHand};
-  std::shared_ptr<Effect> pasiveEffect =
-    std::make_shared<FightEffectWithAdditionalDamageWithCondition>(Skill{0, 0, 1, 0},
-                                                                   0,
-                                                                   1,
-                                                                   std::make_shared<OnlyEnemyEngaged>());
-  expectedCard.RegisterPasiveEffect(pasiveEffect);
+  expectedCard.RegisterPasiveEffect(
+    FightEffectWithAdditionalDamageWithCondition{Skill{0, 0, 1, 0}, 0, 1, OnlyEnemyEngaged{}});
   EXPECT_EQ(*card, expectedCard);
 }
 
@@ -172,7 +171,456 @@ TEST(CardFactory, CheckExistingAssetCard_GuardDog)
   cardSkill.combat = 1;
 
   Asset expectedCard{"Guard Dog", Faction::kGuardian, cardSkill, cost, Slot::kAlly, std::nullopt, health, sanity};
-  std::shared_ptr<Effect> trigger = std::make_shared<MakeDamageToAttacker>(Skill{0, 0, 0, 0}, 0, 1);
-  expectedCard.RegisterTriggerEffect(trigger);
+  expectedCard.RegisterTriggerEffect(MakeDamageToAttacker{Skill{0, 0, 0, 0}, 0, 1});
   EXPECT_EQ(*card, expectedCard);
-}
\ No newline at end of file
+}
+
+TEST(CardDB, CardTableHoldsEveryAsset)
+{
+  auto& cardDB = CardDB::Instance();
+  auto id = cardDB.GetCardId("Machete");
+  ASSERT_NE(id, kInvalidCardId);
+  auto card = std::dynamic_pointer_cast<const Asset>(cardDB.GetCardById(id));
+  ASSERT_THAT(card, NotNull());
+  EXPECT_EQ(*card, *CardFactory::CreateCard<Asset>("Machete"));
+}
+
+TEST(CardDB, UnknownCardHasNoId)
+{
+  EXPECT_EQ(CardDB::Instance().GetCardId(""), kInvalidCardId);
+}
+
+TEST(CardFactory, SharesTheCardPrototype)
+{
+  EXPECT_EQ(CardFactory::CreateCard<Asset>("Beat Cop"), CardFactory::CreateCard<Asset>("Beat Cop"));
+  EXPECT_EQ(CardFactory::CreateCard<Investigator>("Roland Banks"),
+            CardFactory::CreateCard<Investigator>("Roland Banks"));
+}
+
+TEST(AssetState, StartsFromThePrototype)
+{
+  auto card = CardFactory::CreateCard<Asset>("Beat Cop");
+  AssetState state{CardDB::Instance().GetCardId("Beat Cop"), *card};
+  EXPECT_EQ(state.usesLeft, 0);
+  EXPECT_FALSE(state.IsDefeated(*card));
+  state.damage = 2;
+  EXPECT_TRUE(state.IsDefeated(*card));
+}
+
+TEST(CardImage, RoundTripsTheCardFile)
+{
+  const auto tables = CardDBReader::ReadJson(CardDB::kCardFilePath);
+  const auto bytes = CardImage::Write(tables);
+  const auto image = CardImage::Read(bytes);
+  ASSERT_EQ(image.investigators.size(), tables.investigators.size());
+  ASSERT_EQ(image.assets.size(), tables.assets.size());
+
+  const auto& roland = image.investigators.at("Roland Banks");
+  EXPECT_EQ(roland.skill, (Skill{3, 3, 4, 2}));
+  EXPECT_EQ(roland.subname, "The Fed");
+
+  const auto& machete = image.assets.at("Machete");
+  const auto& pasive = machete.effects.at(EffectType::kPasive);
+  ASSERT_EQ(pasive.size(), 1);
+  EXPECT_EQ(pasive.at(0).action, "fight");
+  EXPECT_EQ(std::get<std::string_view>(pasive.at(0).modifications.at("condition")), "only_enemy_engaged");
+  EXPECT_EQ(std::get<int8_t>(pasive.at(0).modifications.at("damage")), 1);
+}
+
+TEST(CardImage, ReadsTheTextInPlace)
+{
+  const auto bytes = CardImage::Write(CardDBReader::ReadJson(CardDB::kCardFilePath));
+  const auto image = CardImage::Read(bytes);
+  const auto* begin = reinterpret_cast<const char*>(bytes.data());
+  const auto name = image.assets.at("Machete").name;
+  EXPECT_GE(name.data(), begin);
+  EXPECT_LE(name.data() + name.size(), begin + bytes.size());
+  EXPECT_TRUE(image.strings.empty());
+}
+
+TEST(CardImage, RejectsOtherVersions)
+{
+  auto image = CardImage::Write(CardDBReader::ReadJson(CardDB::kCardFilePath));
+  image.at(offsetof(CardImage::Header, version)) = std::byte{CardImage::kVersion + 1};
+  EXPECT_THROW(CardImage::Read(image), std::runtime_error);
+}
+
+TEST(ArkhamDBReader, StreamsEveryCard)
+{
+  std::vector<ArkhamDBCardData> cards;
+  EXPECT_EQ(ArkhamDBReader::Read(CardDB::kArkhamDBFilePath, cards), 184);
+  ASSERT_EQ(cards.size(), 184);
+
+  const auto machete =
+    std::find_if(cards.begin(), cards.end(), [](const auto& card) { return card.code == "01020"; });
+  ASSERT_NE(machete, cards.end());
+  EXPECT_EQ(machete->name, "Machete");
+  EXPECT_EQ(machete->type_code, "asset");
+  EXPECT_EQ(machete->slot, "Hand");
+  EXPECT_EQ(machete->cost, 3);
+  EXPECT_EQ(machete->skill.combat, 1);
+  EXPECT_FALSE(machete->enemy_fight.has_value());
+}
+
+// The tests share the process wide CardDB, the files and sources a test loads are dropped after it
+struct Test_CardDB: Test
+{
+  void TearDown() override
+  {
+    CardDB::Instance().Reset();
+  }
+};
+
+TEST_F(Test_CardDB, ReadsTheArkhamDBPool)
+{
+  CardDB::Instance().LoadArkhamDB(CardDB::kArkhamDBFilePath);
+  CardDB::Instance().LoadArkhamDB(CardDB::kArkhamDBFilePath);
+  const auto& files = CardDB::Instance().GetSnapshot()->GetArkhamDBFiles();
+  EXPECT_EQ(std::count(files.begin(), files.end(), CardDB::kArkhamDBFilePath), 1);
+  const auto roland = CardDB::Instance().GetArkhamDBCard("01001");
+  ASSERT_TRUE(roland.has_value());
+  EXPECT_EQ(roland->name, "Roland Banks");
+  EXPECT_EQ(roland->skill.combat, 4);
+  EXPECT_EQ(roland->health, 9);
+  EXPECT_FALSE(CardDB::Instance().GetArkhamDBCard("").has_value());
+}
+
+TEST_F(Test_CardDB, ReloadKeepsTheLoadedArkhamDBFiles)
+{
+  const auto path = (std::filesystem::temp_directory_path() / "arkham_test_pack.json").string();
+  std::ofstream{path} << R"([{"code": "99001", "name": "Reloaded Card", "type_code": "asset"}])";
+
+  auto& cardDB = CardDB::Instance();
+  cardDB.LoadArkhamDB(path);
+  cardDB.Reload();
+  const auto card = cardDB.GetArkhamDBCard("99001");
+  ASSERT_TRUE(card.has_value());
+  EXPECT_EQ(card->name, "Reloaded Card");
+  EXPECT_EQ(cardDB.GetSnapshot()->GetArkhamDBFiles().back(), path);
+}
+
+TEST_F(Test_CardDB, ReloadsChangedCardsFromAPath)
+{
+  auto tables = CardDBReader::ReadJson(CardDB::kCardFilePath);
+  auto& machete = tables.assets.at("Machete");
+  machete.cost += 1;
+  const auto path = (std::filesystem::temp_directory_path() / "arkham_test_cards.bin").string();
+  CardImage::WriteFile(tables, path);
+
+  auto& cardDB = CardDB::Instance();
+  const auto cost = cardDB.GetCard<Asset>("Machete")->GetCost();
+  cardDB.Reload(path);
+  EXPECT_EQ(cardDB.GetCard<Asset>("Machete")->GetCost(), cost + 1);
+  cardDB.Reload();
+  EXPECT_EQ(cardDB.GetCard<Asset>("Machete")->GetCost(), cost);
+}
+
+TEST(PerfectHash, FindsEveryKeyAndRejectsOthers)
+{
+  std::vector<std::string> names;
+  for (int i = 0; i < 1000; ++i)
+    names.push_back(fmt::format("card {}", i));
+  const PerfectHash index{std::vector<std::string_view>(names.begin(), names.end())};
+
+  for (uint32_t i = 0; i < names.size(); ++i)
+    EXPECT_EQ(index.Lookup(names[i]), i);
+  EXPECT_EQ(index.Lookup("card 1000"), PerfectHash::kNotFound);
+  EXPECT_EQ(PerfectHash{}.Lookup("card 0"), PerfectHash::kNotFound);
+}
+
+TEST(StringInterner, CardsShareTheNameHandle)
+{
+  const auto machete = CardFactory::CreateCard<Asset>("Machete");
+  ASSERT_NE(machete, nullptr);
+  EXPECT_EQ(machete->GetName(), "Machete");
+  EXPECT_EQ(StringInterner::Instance().Intern("Machete"), machete->GetNameHandle());
+}
+
+TEST(StringInterner, InternsEachStringOnce)
+{
+  auto& interner = StringInterner::Instance();
+  const auto handle = interner.Intern("InternedOnce");
+  const auto size = interner.Size();
+  EXPECT_EQ(interner.Intern(std::string{"InternedOnce"}), handle);
+  EXPECT_EQ(interner.Size(), size);
+  EXPECT_EQ(interner.Get(handle), "InternedOnce");
+  EXPECT_NE(interner.Intern("InternedTwice"), handle);
+}
+
+TEST(StringInterner, KeepsStringsInPlaceAcrossBlocks)
+{
+  auto& interner = StringInterner::Instance();
+  std::vector<NameHandle> handles;
+  for (int i = 0; i < 1000; ++i)
+    handles.push_back(interner.Intern(fmt::format("interned {}", i)));
+  const auto first = interner.Get(handles.front());
+
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_EQ(interner.Get(handles[i]), fmt::format("interned {}", i));
+  EXPECT_EQ(first, "interned 0");
+  EXPECT_THROW(interner.Get(static_cast<NameHandle>(interner.Size())), std::out_of_range);
+}
+
+#ifdef ARKHAM_EMBEDDED_CARDS
+TEST(EmbeddedCards, MatchesTheCardFile)
+{
+  const auto embedded = CardImage::Write(EmbeddedCards::Read(EmbeddedCardData::kTables));
+  EXPECT_EQ(embedded, CardImage::Write(CardDBReader::ReadJson(CardDB::kCardFilePath)));
+}
+
+TEST(EmbeddedCards, HoldsTheCompiledEffects)
+{
+  const auto embedded = EmbeddedCards::Read(EmbeddedCardData::kTables);
+  auto tables = CardDBReader::ReadJson(CardDB::kCardFilePath);
+  for (auto& [name, asset]: tables.assets)
+  {
+    CardDB::CompileEffects(asset);
+    for (size_t type = 0; type < EmbeddedCards::kEffectTypes; ++type)
+    {
+      const auto effectType = static_cast<EffectType>(type);
+      EXPECT_EQ(embedded.assets.at(name).compiled_effects[effectType], asset.compiled_effects[effectType]) << name;
+    }
+  }
+}
+
+TEST(EmbeddedCards, ResolvesIdsAtCompileTime)
+{
+  constexpr CardId machete = EmbeddedCardData::GetAssetId("Machete");
+  EXPECT_EQ(CardDB::Instance().GetCardId("Machete"), machete);
+  EXPECT_EQ(EmbeddedCards::FindAssetId(EmbeddedCardData::kAssets, "Unknown"), kInvalidCardId);
+}
+#endif
+
+TEST(CardDBReader, ReadsOnlyTheRequestedSection)
+{
+  const auto index = CardDBReader::IndexJson(CardDB::kCardFilePath);
+  EXPECT_TRUE(index.sections.contains(CardDBReader::kInvestigatorsKey));
+  EXPECT_TRUE(index.sections.contains(CardDBReader::kAssetsKey));
+
+  CardDBTables tables;
+  CardDBReader::ReadSection(index, CardSection::kAssets, tables);
+  EXPECT_TRUE(tables.investigators.empty());
+  EXPECT_FALSE(tables.assets.empty());
+
+  CardDBReader::ReadSection(index, CardSection::kInvestigators, tables);
+  EXPECT_EQ(CardImage::Write(tables), CardImage::Write(CardDBReader::ReadJson(CardDB::kCardFilePath)));
+}
+
+TEST(CardDB, LoadsSectionsOnDemand)
+{
+  // A new snapshot, earlier tests may have loaded the sections of the current one
+  CardDB::Instance().Reload();
+  EXPECT_FALSE(CardDB::Instance().IsSectionLoaded(CardSection::kInvestigators));
+  EXPECT_FALSE(CardDB::Instance().IsSectionLoaded(CardSection::kAssets));
+  EXPECT_NE(CardFactory::CreateCard<Investigator>("Roland Banks"), nullptr);
+  EXPECT_TRUE(CardDB::Instance().IsSectionLoaded(CardSection::kInvestigators));
+  EXPECT_FALSE(CardDB::Instance().IsSectionLoaded(CardSection::kAssets));
+  EXPECT_NE(CardFactory::CreateCard<Asset>("Machete"), nullptr);
+  EXPECT_TRUE(CardDB::Instance().IsSectionLoaded(CardSection::kAssets));
+}
+
+TEST(CardDB, ReloadKeepsTheHeldSnapshots)
+{
+  auto& cardDB = CardDB::Instance();
+  const auto before = cardDB.GetSnapshot();
+  const auto machete = before->GetCard<Asset>("Machete");
+  ASSERT_NE(machete, nullptr);
+
+  cardDB.Reload();
+  const auto after = cardDB.GetSnapshot();
+  EXPECT_NE(before, after);
+  EXPECT_EQ(before->GetCard<Asset>("Machete"), machete);
+  EXPECT_EQ(*after->GetCard<Asset>("Machete"), *machete);
+  EXPECT_EQ(after->GetCardId("Machete"), before->GetCardId("Machete"));
+  EXPECT_EQ(cardDB.GetSnapshot(), after);
+}
+
+TEST(CardDB, FreesAReplacedSnapshotWhenItIsReleased)
+{
+  auto& cardDB = CardDB::Instance();
+  auto held = cardDB.GetSnapshot();
+  const std::weak_ptr<const CardDB::Snapshot> replaced = held;
+
+  cardDB.Reload();
+  EXPECT_FALSE(replaced.expired());
+  held.reset();
+  EXPECT_TRUE(replaced.expired());
+}
+
+TEST(CardDB, KeepsAReplacedSnapshotWhileAReaderPinsIt)
+{
+  auto& cardDB = CardDB::Instance();
+  std::weak_ptr<const CardDB::Snapshot> replaced;
+  {
+    const auto reader = cardDB.ReadSnapshot();
+    replaced = reader->shared_from_this();
+    cardDB.Reload();
+    EXPECT_NE(&*reader, &*cardDB.ReadSnapshot());
+    EXPECT_FALSE(replaced.expired());
+    EXPECT_EQ(reader->GetCardId("Machete"), cardDB.GetCardId("Machete"));
+  }
+  EpochReclaimer::Instance().Reclaim();
+  EXPECT_TRUE(replaced.expired());
+}
+
+TEST(CardDB, ReadsWhileAnotherThreadReloads)
+{
+  auto& cardDB = CardDB::Instance();
+  const auto machete = cardDB.GetCardId("Machete");
+  std::atomic<bool> reloading{true};
+  std::atomic<size_t> reads{0};
+  {
+    std::vector<std::jthread> readers;
+    for (int i = 0; i < 4; ++i)
+      readers.emplace_back(
+        [&]()
+        {
+          while (reloading.load())
+          {
+            const auto snapshot = cardDB.ReadSnapshot();
+            EXPECT_EQ(snapshot->GetCardById(machete)->GetName(), "Machete");
+            ++reads;
+          }
+        });
+    // Every reload waits for more reads, so the readers keep pinning snapshots that are being replaced
+    for (size_t i = 1; i <= 20; ++i)
+    {
+      while (reads.load() < i * readers.size())
+        std::this_thread::yield();
+      cardDB.Reload();
+    }
+    reloading.store(false);
+  }
+  EpochReclaimer::Instance().Reclaim();
+  EXPECT_EQ(EpochReclaimer::Instance().GetRetiredCount(), 0);
+}
+
+TEST(CardDB, BuildsASectionOnceForManyThreads)
+{
+  // A fresh snapshot, its sections are built by whichever thread asks first
+  CardDB::Instance().Reload();
+  const auto snapshot = CardDB::Instance().GetSnapshot();
+  std::vector<std::shared_ptr<const Asset>> cards(8);
+  {
+    std::vector<std::jthread> threads;
+    for (size_t i = 0; i < cards.size(); ++i)
+      threads.emplace_back([&cards, i]() { cards[i] = CardDB::Instance().GetCard<Asset>("Machete"); });
+  }
+  ASSERT_NE(cards.front(), nullptr);
+  EXPECT_TRUE(
+    std::all_of(cards.begin(), cards.end(), [&cards](const auto& card) { return card == cards.front(); }));
+  EXPECT_EQ(cards.front(), snapshot->GetCard<Asset>("Machete"));
+}
+
+TEST(CardPoolIndex, IntersectsTheAttributeBitmaps)
+{
+  std::vector<ArkhamDBCardData> cards(4);
+  cards[0].faction_code = "guardian";
+  cards[0].type_code = "asset";
+  cards[0].slot = "Hand";
+  cards[0].traits = "Item. Weapon. Melee.";
+  cards[0].cost = 3;
+  cards[0].skill.combat = 1;
+  cards[1] = cards[0];
+  cards[1].cost = 4;
+  cards[2] = cards[0];
+  cards[2].slot = "Hand x2";
+  cards[2].skill.combat = 0;
+  cards[2].skill.wild = 1;
+  cards[3] = cards[0];
+  cards[3].faction_code = "seeker";
+  cards[3].cost = std::nullopt;
+  const CardPoolIndex index{cards};
+
+  auto query = index.Find();
+  query.WithFaction("guardian").WithType("asset").WithSlot("Hand").WithCostAtMost(3);
+  EXPECT_EQ(query.GetCards().ToPositions(), (std::vector<size_t>{0, 2}));
+  query.WithIcon(SkillIcon::kCombat);
+  EXPECT_EQ(query.GetCards().ToPositions(), std::vector<size_t>{0});
+
+  EXPECT_EQ(index.Find().WithTrait("Weapon").GetCards().Count(), 4);
+  EXPECT_EQ(index.Find().WithCostAtMost(10).GetCards().Count(), 3);
+  EXPECT_EQ(index.Find().WithTrait("Spell").GetCards().Count(), 0);
+  EXPECT_EQ(index.Find().WithTrait("Weapon").WithTrait("Melee").GetCards().Count(), 4);
+
+  cards[1].cost = 12;
+  const CardPoolIndex expensive{cards};
+  EXPECT_EQ(expensive.Find().WithCostAtMost(10).GetCards().ToPositions(), (std::vector<size_t>{0, 2}));
+  EXPECT_EQ(expensive.Find().WithCostAtMost(11).GetCards().Count(), 2);
+  EXPECT_EQ(expensive.Find().WithCostAtMost(12).GetCards().Count(), 3);
+}
+
+TEST(CardPoolIndex, IndexesMoreTraitsThanATraitMaskHolds)
+{
+  std::vector<ArkhamDBCardData> cards(TraitMask::kMaxTraits + 1);
+  for (size_t position = 0; position < cards.size(); ++position)
+    cards[position].traits = fmt::format("Trait {}.", position);
+  const CardPoolIndex index{cards};
+  EXPECT_EQ(index.Find().WithTrait(fmt::format("Trait {}", TraitMask::kMaxTraits)).GetCards().ToPositions(),
+            std::vector<size_t>{TraitMask::kMaxTraits});
+}
+
+TEST_F(Test_CardDB, QueriesTheArkhamDBPool)
+{
+  CardDB::Instance().LoadArkhamDB(CardDB::kArkhamDBFilePath);
+  const auto snapshot = CardDB::Instance().GetSnapshot();
+  auto query = snapshot->FindArkhamDBCards();
+  query.WithFaction("guardian").WithType("asset").WithCostAtMost(3).WithSlot("Hand").WithIcon(SkillIcon::kCombat);
+
+  std::vector<std::string> names;
+  query.GetCards().ForEach(
+    [&names, &snapshot](const size_t position) { names.push_back(snapshot->GetArkhamDBCards()[position].name); });
+  EXPECT_THAT(names, Contains("Machete"));
+  EXPECT_THAT(names, Not(Contains("Flashlight")));
+}
+
+TEST(TraitRegistry, TokenizesTheCardTraits)
+{
+  auto& registry = TraitRegistry::Instance();
+  const auto machete = CardFactory::CreateCard<Asset>("Machete");
+  ASSERT_NE(machete, nullptr);
+  EXPECT_EQ(machete->GetTraits(), registry.Parse("Item. Weapon. Melee."));
+
+  const auto weapon = registry.Find("Weapon");
+  ASSERT_TRUE(weapon.has_value());
+  EXPECT_EQ(registry.GetName(*weapon), "Weapon");
+  EXPECT_TRUE(machete->HasTrait(*weapon));
+  EXPECT_FALSE(machete->HasTrait(registry.Register("Firearm")));
+
+  auto required = registry.Parse("Weapon. Melee.");
+  EXPECT_TRUE(machete->GetTraits().HasAll(required));
+  required.Set(registry.Register("Firearm"));
+  EXPECT_FALSE(machete->GetTraits().HasAll(required));
+  EXPECT_TRUE(machete->GetTraits().HasAny(required));
+  EXPECT_TRUE(TraitMask{}.Empty());
+}
+
+TEST(CardDB, CompilesTheEffectsOnce)
+{
+  CardDB::ActionDBData action;
+  action.action = "fight";
+  action.skill_effect.skill.combat = 1;
+  action.modifications.insert({"damage", int8_t{1}});
+  action.modifications.insert({"condition", std::string_view{"only_enemy_engaged"}});
+
+  const auto spec = CardDB::CompileEffect(action);
+  ASSERT_TRUE(spec.has_value());
+  EXPECT_EQ(spec->kind, EffectKind::kFightWithAdditionalDamageWithCondition);
+  EXPECT_EQ(spec->condition, EffectCondition::kOnlyEnemyEngaged);
+  EXPECT_EQ(spec->amount, 1);
+  const EffectVariant expected =
+    FightEffectWithAdditionalDamageWithCondition{action.skill_effect.skill, 0, 1, OnlyEnemyEngaged{}};
+  EXPECT_EQ(MakeEffect(spec.value()), expected);
+
+  action.action = "investigate";
+  EXPECT_FALSE(CardDB::CompileEffect(action).has_value());
+}
+
+TEST(CardFactory, KeepsShortEffectListsInline)
+{
+  // Physical Training has two trigger effects, the rest of its lists stay inline and empty
+  const auto card = CardFactory::CreateCard<Asset>("Physical Training");
+  ASSERT_NE(card, nullptr);
+  EXPECT_EQ(card->GetTriggerEffect().size(), 2);
+  EXPECT_TRUE(card->GetActivationEffect().IsInline());
+}
@@ -0,0 +1,55 @@
+#include "chaos_bag.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using namespace ::testing;
+
+struct Test_ChaosBag: Test
+{
+  ChaosBagImpl chaosBag{Philox4x32{1}};
+};
+
+TEST_F(Test_ChaosBag, ThrowsIfEmpty)
+{
+  EXPECT_THROW(chaosBag.GetToken(), std::runtime_error);
+}
+
+TEST_F(Test_ChaosBag, GroupsEqualTokens)
+{
+  chaosBag.AddToken({ChaosToken::Token::kValue, -1});
+  chaosBag.AddToken({ChaosToken::Token::kValue, -1});
+  chaosBag.AddToken({ChaosToken::Token::kSkull, -1});
+  ASSERT_EQ(chaosBag.Size(), 3);
+  ASSERT_EQ(chaosBag.GetTokenCounts().size(), 2);
+  EXPECT_EQ(chaosBag.GetTokenCounts().at(0).count, 2);
+  EXPECT_EQ(chaosBag.GetTokenCounts().at(1).count, 1);
+}
+
+TEST_F(Test_ChaosBag, ThrowsPastTheCountOfAKind)
+{
+  const ChaosToken token{ChaosToken::Token::kValue, 0};
+  for (int i = 0; i < UINT8_MAX; ++i)
+    chaosBag.AddToken(token);
+  EXPECT_THROW(chaosBag.AddToken(token), std::length_error);
+  EXPECT_EQ(chaosBag.GetTokenCounts().at(0).count, UINT8_MAX);
+  EXPECT_EQ(chaosBag.Size(), UINT8_MAX);
+}
+
+TEST_F(Test_ChaosBag, SingleTokenIsAlwaysDrawn)
+{
+  ChaosToken token{ChaosToken::Token::kElderSign, 1};
+  chaosBag.AddToken(token);
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(chaosBag.GetToken(), token);
+}
+
+TEST_F(Test_ChaosBag, DrawsOnlyTokensInTheBag)
+{
+  chaosBag.AddToken({ChaosToken::Token::kValue, 0});
+  chaosBag.AddToken({ChaosToken::Token::kAutoFail, 0});
+  for (int i = 0; i < 1000; ++i)
+  {
+    auto token = chaosBag.GetToken();
+    EXPECT_THAT(token.token, AnyOf(ChaosToken::Token::kValue, ChaosToken::Token::kAutoFail));
+  }
+}
@@ -0,0 +1,82 @@
+#include "condition_evaluator.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mock/mock_condition_state.h"
+
+using namespace ::testing;
+
+struct Test_ConditionEvaluator: Test
+{
+  NiceMock<Mock_ConditionState> state;
+  ConditionEpochs epochs;
+  ConditionEvaluator evaluator{state};
+
+  Test_ConditionEvaluator()
+  {
+    ON_CALL(state, GetEngagementEpoch()).WillByDefault([this]() { return epochs.engagement; });
+    ON_CALL(state, GetCluesEpoch()).WillByDefault([this]() { return epochs.clues; });
+  }
+};
+
+TEST_F(Test_ConditionEvaluator, EffectsWithoutConditionAlwaysApply)
+{
+  EXPECT_CALL(state, IsEnemyEngaged()).Times(0);
+  EXPECT_TRUE(evaluator.Evaluate(ConditionVariant{}));
+}
+
+TEST_F(Test_ConditionEvaluator, EvaluatesOnceForEachEngagementEpoch)
+{
+  const FightEffectWithAdditionalDamageWithCondition machete{Skill{0, 0, 1, 0}, 0, 1, OnlyEnemyEngaged{}};
+  EXPECT_CALL(state, IsEnemyEngaged()).WillOnce(Return(true)).WillOnce(Return(false));
+  for (int candidate = 0; candidate < 10; ++candidate)
+    EXPECT_TRUE(evaluator.Evaluate(machete));
+
+  // Clues do not change engagement
+  epochs.CluesChanged();
+  EXPECT_TRUE(evaluator.Evaluate(machete));
+  epochs.EngagementChanged();
+  EXPECT_FALSE(evaluator.Evaluate(machete));
+  EXPECT_FALSE(evaluator.Evaluate(machete));
+}
+
+TEST_F(Test_ConditionEvaluator, EvaluatesUndiscoveredClues)
+{
+  EXPECT_CALL(state, GetUndiscoveredClues()).WillOnce(Return(2)).WillOnce(Return(0));
+  EXPECT_TRUE(evaluator.Evaluate(LocationOptionalEffectCondition::kUndiscoveredClues));
+  EXPECT_TRUE(evaluator.Evaluate(LocationOptionalEffectCondition::kUndiscoveredClues));
+  epochs.CluesChanged();
+  EXPECT_FALSE(evaluator.Evaluate(LocationOptionalEffectCondition::kUndiscoveredClues));
+  EXPECT_FALSE(evaluator.Evaluate(LocationOptionalEffectCondition::kInvalid));
+}
+
+TEST_F(Test_ConditionEvaluator, EvaluatesAgainForAnotherInvestigator)
+{
+  const FightEffectWithAdditionalDamageWithCondition machete{Skill{0, 0, 1, 0}, 0, 1, OnlyEnemyEngaged{}};
+  CardInPlayId investigator = 1;
+  ON_CALL(state, GetActingInvestigator()).WillByDefault([&investigator]() { return investigator; });
+  EXPECT_CALL(state, IsEnemyEngaged()).WillOnce(Return(true)).WillOnce(Return(false)).WillOnce(Return(true));
+  EXPECT_TRUE(evaluator.Evaluate(machete));
+  EXPECT_TRUE(evaluator.Evaluate(machete));
+
+  // Same epochs, but the action is now taken by another investigator
+  investigator = 2;
+  EXPECT_FALSE(evaluator.Evaluate(machete));
+  EXPECT_FALSE(evaluator.Evaluate(machete));
+  investigator = 1;
+  EXPECT_TRUE(evaluator.Evaluate(machete));
+}
+
+TEST_F(Test_ConditionEvaluator, EvaluatesAgainWhenTheInvestigatorMoves)
+{
+  CardInPlayId location = 10;
+  ON_CALL(state, GetActingLocation()).WillByDefault([&location]() { return location; });
+  EXPECT_CALL(state, GetUndiscoveredClues()).WillOnce(Return(1)).WillOnce(Return(0)).WillOnce(Return(1));
+  EXPECT_TRUE(evaluator.Evaluate(LocationOptionalEffectCondition::kUndiscoveredClues));
+
+  // No clue changed, but the investigator is now at a location without clues
+  location = 11;
+  EXPECT_FALSE(evaluator.Evaluate(LocationOptionalEffectCondition::kUndiscoveredClues));
+  EXPECT_FALSE(evaluator.Evaluate(LocationOptionalEffectCondition::kUndiscoveredClues));
+  location = 10;
+  EXPECT_TRUE(evaluator.Evaluate(LocationOptionalEffectCondition::kUndiscoveredClues));
+}
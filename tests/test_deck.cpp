@@ -16,7 +16,7 @@ struct Test_BasicDeck: Test
 {
   typedef std::vector<std::shared_ptr<Card>> CardVector;
   typedef std::queue<std::shared_ptr<Card>> CardQueue;
-  DeckImpl<CardVector> deck;
+  DeckImpl<CardVector> deck{Philox4x32{1}};
   Test_BasicDeck()
   {
     EXPECT_TRUE(deck.Empty());
@@ -45,3 +45,82 @@ TEST_F(Test_DrawDeck, DrawCard)
   ASSERT_TRUE(CompareCard<SkillCard>(card, expectedCard));
 }
 
+struct Test_RingDeck: Test
+{
+  typedef RingBuffer<std::shared_ptr<Card>, 4> CardRing;
+  DeckImpl<CardRing> deck{Philox4x32{1}};
+
+  void AddCard(const std::string& name)
+  {
+    deck.AddCard(std::make_shared<SkillCard>(name, Faction::kInvalid, Skill{}));
+  }
+};
+
+TEST_F(Test_RingDeck, DrawsInInsertionOrderAcrossTheEnd)
+{
+  AddCard("CardId0");
+  AddCard("CardId1");
+  AddCard("CardId2");
+  deck.DrawCard();
+  deck.DrawCard();
+  AddCard("CardId3");
+  AddCard("CardId4");
+  AddCard("CardId5");
+  ASSERT_EQ(deck.Size(), 4);
+  for (const auto& name: {"CardId2", "CardId3", "CardId4", "CardId5"})
+  {
+    auto card = deck.DrawCard();
+    ASSERT_TRUE(CompareCard<SkillCard>(card, std::make_shared<SkillCard>(name, Faction::kInvalid, Skill{})));
+  }
+  ASSERT_TRUE(deck.Empty());
+}
+
+TEST_F(Test_RingDeck, ThrowsWhenFull)
+{
+  for (const auto& name: {"CardId0", "CardId1", "CardId2", "CardId3"})
+    AddCard(name);
+  EXPECT_THROW(AddCard("CardId4"), std::length_error);
+}
+
+TEST_F(Test_RingDeck, ThrowsWhenEmpty)
+{
+  EXPECT_THROW(deck.DrawCard(), std::runtime_error);
+  AddCard("CardId0");
+  deck.DrawCard();
+  EXPECT_THROW(deck.DrawCard(), std::runtime_error);
+
+  CardRing ring;
+  EXPECT_THROW(ring.front(), std::out_of_range);
+  EXPECT_THROW(ring.pop_front(), std::out_of_range);
+  EXPECT_TRUE(ring.empty());
+}
+
+TEST_F(Test_RingDeck, ShuffleKeepsTheCards)
+{
+  AddCard("CardId0");
+  deck.DrawCard();
+  for (const auto& name: {"CardId1", "CardId2", "CardId3", "CardId4"})
+    AddCard(name);
+  deck.Shuffle();
+  ASSERT_EQ(deck.Size(), 4);
+  int found = 0;
+  while (!deck.Empty())
+  {
+    auto card = deck.DrawCard();
+    for (const auto& name: {"CardId1", "CardId2", "CardId3", "CardId4"})
+      found += *dynamic_cast<SkillCard*>(card.get()) == SkillCard{name, Faction::kInvalid, Skill{}};
+  }
+  EXPECT_EQ(found, 4);
+}
+
+TEST(Test_CardIdDeck, CopiesAndHashesById)
+{
+  DeckImpl<RingBuffer<CardId, 8>> deck{Philox4x32{1}};
+  for (CardId id = 0; id < 5; ++id)
+    deck.AddCard(id);
+  auto copy = deck;
+  EXPECT_EQ(copy.GetCards().Hash(), deck.GetCards().Hash());
+  EXPECT_EQ(copy.DrawCard(), 0);
+  EXPECT_NE(copy.GetCards().Hash(), deck.GetCards().Hash());
+  EXPECT_EQ(deck.Size(), 5);
+}
@@ -0,0 +1,70 @@
+#include "game.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "mock/mock_player.h"
+#include "random.h"
+
+using namespace ::testing;
+
+// Known answers from the Random123 distribution
+TEST(Philox4x32, KnownAnswers)
+{
+  EXPECT_THAT(Philox4x32::Generate({0, 0, 0, 0}, {0, 0}),
+              ElementsAre(0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8));
+  EXPECT_THAT(Philox4x32::Generate({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}),
+              ElementsAre(0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1));
+}
+
+TEST(Philox4x32, SameSeedAndStreamGiveSameSequence)
+{
+  Philox4x32 lhs{42, 7};
+  Philox4x32 rhs{42, 7};
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(lhs(), rhs());
+}
+
+TEST(Philox4x32, StreamsAreIndependent)
+{
+  Philox4x32 generator{42};
+  auto lhs = generator.Split(0);
+  auto rhs = generator.Split(1);
+  int equal = 0;
+  for (int i = 0; i < 100; ++i)
+    equal += lhs() == rhs();
+  EXPECT_LT(equal, 2);
+}
+
+TEST(Philox4x32, DiscardSkipsOutputs)
+{
+  Philox4x32 generator{3, 4};
+  Philox4x32 skipped{3, 4};
+  for (int i = 0; i < 13; ++i)
+    generator();
+  skipped.discard(13);
+  EXPECT_EQ(generator(), skipped());
+}
+
+TEST(Game, GivesEveryPlayerAStreamOfTheSeed)
+{
+  struct TestGame: Game
+  {};
+  TestGame game;
+  std::vector<uint32_t> firstDraws;
+  auto addPlayer = [&game, &firstDraws]()
+  {
+    auto player = std::make_unique<NiceMock<Mock_Player>>();
+    ON_CALL(*player, SetGenerator(_))
+      .WillByDefault([&firstDraws](Philox4x32 generator) { firstDraws.push_back(generator()); });
+    game.AddPlayer(std::move(player));
+  };
+
+  addPlayer();
+  // Seeding restarts the player already added from its stream of the seed
+  game.Seed(7);
+  addPlayer();
+  ASSERT_EQ(firstDraws.size(), 3);
+  EXPECT_EQ(firstDraws[1], game.GetGenerator(0)());
+  EXPECT_EQ(firstDraws[2], game.GetGenerator(1)());
+  EXPECT_EQ(firstDraws[1], Philox4x32{7}.Split(1)());
+  EXPECT_NE(firstDraws[1], firstDraws[2]);
+}
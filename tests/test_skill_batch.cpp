@@ -0,0 +1,63 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "skill_batch.h"
+
+#include <random>
+
+using namespace ::testing;
+
+TEST(PackedSkill, AddsWildToEverySkill)
+{
+  auto packed = PackedSkill::FromSkill({1, 2, 3, 4, 1});
+  EXPECT_EQ(packed.values[Willpower::kIndex], 2);
+  EXPECT_EQ(packed.values[Intellect::kIndex], 3);
+  EXPECT_EQ(packed.values[Combat::kIndex], 4);
+  EXPECT_EQ(packed.values[Agility::kIndex], 5);
+}
+
+TEST(SkillTestBatch, EvaluatesAllSkills)
+{
+  SkillTestBatch batch;
+  auto test = batch.Add(PackedSkill::FromSkill({3, 1, 4, 2}),
+                        PackedSkill::FromSkill({0, 0, 0, 0, 1}),
+                        -2,
+                        PackedSkill::FromDifficulty({2, 2, 2, -1}));
+  batch.Evaluate();
+  EXPECT_EQ(batch.GetMargin<Willpower>(test), 0);
+  EXPECT_TRUE(batch.Succeeds<Willpower>(test));
+  EXPECT_EQ(batch.GetMargin<Intellect>(test), -2);
+  EXPECT_FALSE(batch.Succeeds<Intellect>(test));
+  EXPECT_EQ(batch.GetMargin<Combat>(test), 1);
+  EXPECT_TRUE(batch.Succeeds<Combat>(test));
+  EXPECT_EQ(batch.GetMargin<Agility>(test), 1);
+  EXPECT_TRUE(batch.Succeeds<Agility>(test));
+}
+
+TEST(SkillTestBatch, VectorKernelMatchesScalarKernel)
+{
+  const size_t count = 1003;
+  std::mt19937 generator{1};
+  std::uniform_int_distribution<int> distribution{-128, 127};
+  std::vector<int8_t> skills(count), commited(count), modifiers(count), difficulties(count);
+  for (auto* values: {&skills, &commited, &modifiers, &difficulties})
+    std::generate(values->begin(), values->end(), [&]() { return static_cast<int8_t>(distribution(generator)); });
+
+  std::vector<int8_t> margins(count), expectedMargins(count);
+  std::vector<uint8_t> success(count), expectedSuccess(count);
+  SkillTestBatch::Evaluate(skills.data(),
+                           commited.data(),
+                           modifiers.data(),
+                           difficulties.data(),
+                           margins.data(),
+                           success.data(),
+                           count);
+  SkillTestBatch::EvaluateScalar(skills.data(),
+                                 commited.data(),
+                                 modifiers.data(),
+                                 difficulties.data(),
+                                 expectedMargins.data(),
+                                 expectedSuccess.data(),
+                                 count);
+  EXPECT_EQ(margins, expectedMargins);
+  EXPECT_EQ(success, expectedSuccess);
+}
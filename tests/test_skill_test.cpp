@@ -1,9 +1,17 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
+#include "card_db_reader.h"
+#include "card_factory.h"
+#include "card_image.h"
+#include "commit_solver.h"
 #include "mock/mock_chaos_bag.h"
 #include "mock/mock_player.h"
 #include "skill_test.h"
+#include "skill_test_probability.h"
+#include "skill_test_simulator.h"
+#include "token_table.h"
 
+#include <filesystem>
 #include <string>
 
 using namespace ::testing;
@@ -15,6 +23,11 @@ private:
   std::unique_ptr<NiceMock<Mock_Player>> mockPlayerTmp{std::make_unique<NiceMock<Mock_Player>>()};
 
 public:
+  Test_SkillTest()
+  {
+    ON_CALL(mockPlayer, GetTokenTable()).WillByDefault(ReturnRef(TokenTable::Default()));
+  }
+
   Mock_Player& mockPlayer{*mockPlayerTmp.get()};
   Mock_ChaosBag& mockChaosBag{*mockChaosBagTmp.get()};
 };
@@ -95,3 +108,299 @@ TEST_F(Test_SkillTestWillpower, WillpowerTestFailsWithCommitedCardsFromOtherSkil
             playerSkill.willpower - skillTested.willpower + chaosToken.effect
               + Willpower::GetSkillValue(asset->GetSkill()));
 }
+
+TEST_F(Test_SkillTestWillpower, WillpowerTestAddsThePassiveModifiers)
+{
+  ChaosToken chaosToken{ChaosToken::Token::kValue, -2};
+  EXPECT_CALL(mockChaosBag, GetToken()).WillOnce(Return(chaosToken));
+  EXPECT_CALL(mockPlayer, GetSkill()).WillOnce(ReturnRef(playerSkill));
+  EXPECT_CALL(mockPlayer, GetSkillModifier()).WillOnce(Return(Skill{1, 0, 0, 0}));
+  auto [succeed, difference] = skillTest(skillTested, mockPlayer, mockChaosBag, {});
+  EXPECT_TRUE(succeed);
+  EXPECT_EQ(difference, 0);
+}
+
+TEST_F(Test_SkillTest, CommitsCardIdsFromTheGivenSnapshot)
+{
+  const Skill playerSkill{0, 0, 2, 0};
+  const auto snapshot = CardDB::Instance().GetSnapshot();
+  const auto machete = snapshot->GetCardById(snapshot->GetCardId("Machete"));
+  const std::vector<CardId> commitedCards{snapshot->GetCardId("Machete")};
+  EXPECT_CALL(mockPlayer, GetSkill()).WillOnce(ReturnRef(playerSkill));
+  EXPECT_EQ(SkillTest<Combat>::GetSkillValue(mockPlayer, commitedCards, *snapshot),
+            2 + Combat::GetSkillValue(machete->GetSkill()));
+}
+
+TEST(SkillAggregate, FollowsTheCardsInPlay)
+{
+  // Beat Cop adds one combat while in play, Machete only adds it when fighting
+  const auto beatCop = CardFactory::CreateCard<Asset>("Beat Cop");
+  const auto machete = CardFactory::CreateCard<Asset>("Machete");
+  ASSERT_THAT(beatCop, NotNull());
+  ASSERT_THAT(machete, NotNull());
+
+  SkillAggregate passives;
+  passives.Add(1, *beatCop);
+  passives.Add(2, *beatCop);
+  passives.Add(3, *machete);
+  EXPECT_EQ(passives.Get(), (Skill{0, 0, 2, 0}));
+  passives.SetActive(1, false);
+  EXPECT_EQ(passives.Get(), (Skill{0, 0, 1, 0}));
+  passives.Remove(1);
+  passives.Remove(2);
+  EXPECT_EQ(passives.Get(), Skill{});
+  passives.SetActive(1, true);
+  EXPECT_EQ(passives.Get(), Skill{});
+}
+
+struct Test_SkillTestProbabilityWillpower: Test_SkillTest
+{
+  Skill skillTested{2, 0, 0, 0};
+  Skill playerSkill{3, 0, 0, 0};
+  ChaosBagImpl chaosBag{Philox4x32{1}};
+  SkillTestProbability<Willpower> probability;
+};
+
+TEST_F(Test_SkillTestProbabilityWillpower, EmptyBag)
+{
+  EXPECT_CALL(mockPlayer, GetSkill()).WillOnce(ReturnRef(playerSkill));
+  auto odds = probability(skillTested, mockPlayer, chaosBag, {});
+  EXPECT_DOUBLE_EQ(odds.success, 0.0);
+  EXPECT_TRUE(odds.margins.empty());
+}
+
+TEST_F(Test_SkillTestProbabilityWillpower, WeightsTokensByCount)
+{
+  chaosBag.AddToken({ChaosToken::Token::kValue, 0});
+  chaosBag.AddToken({ChaosToken::Token::kValue, 0});
+  chaosBag.AddToken({ChaosToken::Token::kSkull, -2});
+  chaosBag.AddToken({ChaosToken::Token::kAutoFail, 0});
+  EXPECT_CALL(mockPlayer, GetSkill()).WillOnce(ReturnRef(playerSkill));
+  auto odds = probability(skillTested, mockPlayer, chaosBag, {});
+  EXPECT_DOUBLE_EQ(odds.success, 0.5);
+  EXPECT_DOUBLE_EQ(odds.autoFail, 0.25);
+  EXPECT_DOUBLE_EQ(odds.margins.at(1), 0.5);
+  EXPECT_DOUBLE_EQ(odds.margins.at(-1), 0.25);
+}
+
+TEST_F(Test_SkillTestProbabilityWillpower, CountsCommitedCards)
+{
+  chaosBag.AddToken({ChaosToken::Token::kValue, -2});
+  std::shared_ptr<Card> asset =
+    std::make_shared<Asset>("InventedCard", Faction::kInvalid, Skill{0, 0, 0, 0, 1}, 0, Slot::kInvalid);
+  EXPECT_CALL(mockPlayer, GetSkill()).WillOnce(ReturnRef(playerSkill));
+  auto odds = probability(skillTested, mockPlayer, chaosBag, {asset});
+  EXPECT_DOUBLE_EQ(odds.success, 1.0);
+  EXPECT_DOUBLE_EQ(odds.margins.at(0), 1.0);
+}
+
+struct Test_SkillTestSimulatorWillpower: Test_SkillTestProbabilityWillpower
+{
+  Test_SkillTestSimulatorWillpower()
+  {
+    chaosBag.AddToken({ChaosToken::Token::kValue, 0});
+    chaosBag.AddToken({ChaosToken::Token::kValue, -2});
+    chaosBag.AddToken({ChaosToken::Token::kAutoFail, 0});
+    chaosBag.AddToken({ChaosToken::Token::kValue, 1});
+    EXPECT_CALL(mockPlayer, GetSkill()).WillRepeatedly(ReturnRef(playerSkill));
+  }
+};
+
+TEST_F(Test_SkillTestSimulatorWillpower, ReproducibleForAnyNumberOfThreads)
+{
+  auto single = SkillTestSimulator<Willpower>{42, 1}.Run(skillTested, mockPlayer, chaosBag, {}, 100000);
+  auto multiple = SkillTestSimulator<Willpower>{42, 4}.Run(skillTested, mockPlayer, chaosBag, {}, 100000);
+  EXPECT_EQ(single.trials, 100000);
+  EXPECT_EQ(single.successes, multiple.successes);
+  EXPECT_EQ(single.autoFails, multiple.autoFails);
+  EXPECT_EQ(single.margins, multiple.margins);
+}
+
+TEST_F(Test_SkillTestSimulatorWillpower, ConvergesToExactProbability)
+{
+  auto simulation = SkillTestSimulator<Willpower>{7}.Run(skillTested, mockPlayer, chaosBag, {}, 200000);
+  auto odds = probability(skillTested, mockPlayer, chaosBag, {});
+  auto [low, high] = simulation.GetConfidenceInterval(4.0);
+  EXPECT_LE(low, odds.success);
+  EXPECT_GE(high, odds.success);
+}
+
+struct Test_CommitSolverWillpower: Test_SkillTestProbabilityWillpower
+{
+  Test_CommitSolverWillpower()
+  {
+    // Standard bag of the first scenario without its symbol tokens
+    for (const int8_t effect: {1, 0, 0, -1, -1, -1, -2, -2, -3, -4})
+      chaosBag.AddToken({ChaosToken::Token::kValue, effect});
+    chaosBag.AddToken({ChaosToken::Token::kAutoFail, 0});
+    EXPECT_CALL(mockPlayer, GetSkill()).WillRepeatedly(ReturnRef(playerSkill));
+    skillTested = Skill{4, 0, 0, 0};
+  }
+
+  static std::vector<std::shared_ptr<Card>> MakeHand(const std::vector<int8_t>& icons)
+  {
+    std::vector<std::shared_ptr<Card>> hand;
+    for (const auto willpower: icons)
+      hand.push_back(
+        std::make_shared<Asset>("InventedCard", Faction::kInvalid, Skill{willpower, 0, 0, 0}, 0, Slot::kInvalid));
+    return hand;
+  }
+};
+
+TEST_F(Test_CommitSolverWillpower, CommitsTheCheapestSetReachingTheTarget)
+{
+  const auto hand = MakeHand({1, 0, 2, 1, 0, 1, 2, 1, 0, 1, 1, 3});
+  const std::vector<uint32_t> costs{1, 1, 3, 1, 1, 2, 2, 1, 1, 1, 1, 5};
+  for (const double target: {0.0, 0.5, 0.7, 0.85, 0.95})
+  {
+    CommitSolver<Willpower> solver{skillTested, mockPlayer, chaosBag, hand, target, costs};
+    const auto solution = solver.Solve();
+
+    // Every subset of the hand, the cheapest one reaching the target must cost what the solver found
+    uint32_t cheapest = std::numeric_limits<uint32_t>::max();
+    for (uint32_t cards = 0; cards < (1u << hand.size()); ++cards)
+    {
+      std::vector<std::shared_ptr<Card>> commited;
+      uint32_t cost = 0;
+      for (size_t i = 0; i < hand.size(); ++i)
+      {
+        if (cards & (1u << i))
+        {
+          commited.push_back(hand[i]);
+          cost += costs[i];
+        }
+      }
+      if (probability(skillTested, mockPlayer, chaosBag, commited).success >= target)
+        cheapest = std::min(cheapest, cost);
+    }
+
+    // The autofail token keeps the last target out of reach
+    EXPECT_EQ(solution.reachesTarget, cheapest != std::numeric_limits<uint32_t>::max()) << target;
+    if (solution.reachesTarget)
+    {
+      EXPECT_EQ(solution.cost, cheapest) << target;
+      EXPECT_GE(solution.success, target);
+    }
+  }
+}
+
+TEST_F(Test_CommitSolverWillpower, ReportsTargetsOutOfReach)
+{
+  const auto hand = MakeHand({1, 0, 1});
+  CommitSolver<Willpower> solver{skillTested, mockPlayer, chaosBag, hand, 0.99};
+  const auto solution = solver.Solve();
+  EXPECT_FALSE(solution.reachesTarget);
+  EXPECT_EQ(solution.cards, 0b101);
+  EXPECT_DOUBLE_EQ(solution.success, solver.GetSuccess(2));
+
+  // Without the first card only the last one still helps
+  EXPECT_EQ(solver.Solve(0b110).cards, 0b100);
+}
+
+TEST_F(Test_CommitSolverWillpower, OnlyCommitsAvailableCards)
+{
+  const auto hand = MakeHand({1, 2, 0, 1, 1, 3, 0, 2, 1, 1, 2, 1});
+  CommitSolver<Willpower> solver{skillTested, mockPlayer, chaosBag, hand, 0.8};
+  for (uint32_t available = 0; available < 64; ++available)
+  {
+    const auto solution = solver.Solve(CommitSolver<Willpower>::kWholeHand & ~available);
+    EXPECT_EQ(solution.cards & available, 0u) << available;
+  }
+}
+
+struct Test_TokenTable: Test_SkillTestProbabilityWillpower
+{
+  Investigator investigator{"InventedInvestigator", Faction::kInvalid, Skill{3, 3, 3, 3}, 7, 7};
+};
+
+TEST_F(Test_TokenTable, DefaultCountsTheTokenValue)
+{
+  const auto& table = TokenTable::Default();
+  EXPECT_TRUE(table.Get(ChaosToken::Token::kAutoFail).autoFail);
+  EXPECT_FALSE(table.Get(ChaosToken::Token::kSkull).autoFail);
+  EXPECT_EQ(table.Resolve<Willpower>({ChaosToken::Token::kSkull, -2}), -2);
+  EXPECT_EQ(table.Resolve<Combat>({ChaosToken::Token::kValue, 1}), 1);
+}
+
+TEST_F(Test_TokenTable, ElderSignAddsTheInvestigatorAbility)
+{
+  investigator.RegisterElderSign(Effect{Skill{0, 2, 0, 0}, 0});
+  const auto table = TokenTable::Build(investigator);
+  const ChaosToken elderSign{ChaosToken::Token::kElderSign, 1};
+  EXPECT_EQ(table.Resolve<Intellect>(elderSign), 3);
+  EXPECT_EQ(table.Resolve<Willpower>(elderSign), 1);
+}
+
+TEST_F(Test_TokenTable, ScenarioReplacesTheTokenValue)
+{
+  ScenarioTokens scenario;
+  scenario[static_cast<size_t>(ChaosToken::Token::kSkull)] = -3;
+  scenario[static_cast<size_t>(ChaosToken::Token::kAutoFail)] = 0;
+  const auto table = TokenTable::Build(investigator, scenario);
+  EXPECT_EQ(table.Resolve<Willpower>({ChaosToken::Token::kSkull, -1}), -3);
+  EXPECT_EQ(table.Resolve<Willpower>({ChaosToken::Token::kCultist, -1}), -1);
+  // The autofail fails whatever the scenario says
+  EXPECT_TRUE(table.Get(ChaosToken::Token::kAutoFail).autoFail);
+}
+
+TEST_F(Test_TokenTable, SkillTestAndProbabilityResolveWithThePlayerTable)
+{
+  ScenarioTokens scenario;
+  scenario[static_cast<size_t>(ChaosToken::Token::kSkull)] = -1;
+  const auto table = TokenTable::Build(investigator, scenario);
+  chaosBag.AddToken({ChaosToken::Token::kSkull, -2});
+  EXPECT_CALL(mockPlayer, GetSkill()).WillRepeatedly(ReturnRef(playerSkill));
+  EXPECT_CALL(mockPlayer, GetTokenTable()).WillRepeatedly(ReturnRef(table));
+
+  auto odds = probability(skillTested, mockPlayer, chaosBag, {});
+  EXPECT_DOUBLE_EQ(odds.success, 1.0);
+  EXPECT_DOUBLE_EQ(odds.margins.at(0), 1.0);
+
+  EXPECT_CALL(mockChaosBag, GetToken()).WillOnce(Return(ChaosToken{ChaosToken::Token::kSkull, -2}));
+  auto [succeed, difference] = SkillTest<Willpower>{}(skillTested, mockPlayer, mockChaosBag, {});
+  EXPECT_TRUE(succeed);
+  EXPECT_EQ(difference, 0);
+}
+
+TEST(PlayerImpl, ResolvesTheTokensOfTheLoadedScenario)
+{
+  PlayerImpl player{"Player", "Roland Banks", CardDB::Instance().GetSnapshot(), Philox4x32{1}};
+  const ChaosToken skull{ChaosToken::Token::kSkull, -1};
+  EXPECT_EQ(player.GetTokenTable().Resolve<Combat>(skull), -1);
+
+  ScenarioTokens scenario;
+  scenario[static_cast<size_t>(ChaosToken::Token::kSkull)] = -2;
+  player.LoadScenario(scenario);
+  EXPECT_EQ(player.GetTokenTable().Resolve<Combat>(skull), -2);
+}
+
+struct Test_PlayerImplReload: Test
+{
+  void TearDown() override
+  {
+    CardDB::Instance().Reset();
+  }
+};
+
+TEST_F(Test_PlayerImplReload, KeepsTheCardsOfItsHandAcrossAReload)
+{
+  auto& cardDB = CardDB::Instance();
+  PlayerImpl player{"Player", "Roland Banks", cardDB.GetSnapshot(), Philox4x32{1}};
+  const auto machete = player.GetSnapshot().GetCardId("Machete");
+  player.AddCardToDeck(machete);
+  player.DrawCard();
+  const auto skillValue = SkillTest<Combat>::GetSkillValue(player, player.GetHand(), player.GetSnapshot());
+
+  // Sorts before every card, the id the hand holds is another card in the new card table
+  auto tables = CardDBReader::ReadJson(CardDB::kCardFilePath);
+  auto firstCard = tables.assets.at("Flashlight");
+  firstCard.name = tables.Store("AAA Inserted Card");
+  tables.assets.emplace(firstCard.name, std::move(firstCard));
+  const auto path = (std::filesystem::temp_directory_path() / "arkham_test_inserted_card.bin").string();
+  CardImage::WriteFile(tables, path);
+  cardDB.Reload(path);
+  ASSERT_NE(cardDB.GetCardById(machete)->GetName(), std::string_view{"Machete"});
+
+  EXPECT_EQ(player.GetSnapshot().GetCardById(player.GetHand().front())->GetName(), std::string_view{"Machete"});
+  EXPECT_EQ(SkillTest<Combat>::GetSkillValue(player, player.GetHand(), player.GetSnapshot()), skillValue);
+}
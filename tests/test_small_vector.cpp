@@ -0,0 +1,36 @@
+#include "effect.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "small_vector.h"
+
+#include <string>
+
+using namespace ::testing;
+
+TEST(SmallVector, SpillsToTheHeapPastItsInlineCapacity)
+{
+  SmallVector<EffectVariant, 1> effects;
+  EXPECT_TRUE(effects.empty());
+  effects.push_back(Effect{Skill{1, 0, 0, 0}, 1});
+  EXPECT_TRUE(effects.IsInline());
+  effects.push_back(MakeDamageToAttacker{Skill{}, 0, 1});
+  EXPECT_FALSE(effects.IsInline());
+  ASSERT_EQ(effects.size(), 2);
+  EXPECT_EQ(effects[0], EffectVariant{Effect(Skill{1, 0, 0, 0}, 1)});
+
+  auto moved = std::move(effects);
+  EXPECT_TRUE(effects.empty());
+  EXPECT_EQ(moved.size(), 2);
+  auto copy = moved;
+  EXPECT_EQ(copy, moved);
+}
+
+TEST(SmallVector, CopiesItsOwnElementWhenGrowing)
+{
+  SmallVector<std::string, 1> names{std::string(32, 'a')};
+  names.push_back(names[0]);
+  names.push_back(names[1]);
+  ASSERT_EQ(names.size(), 3);
+  EXPECT_EQ(names[1], std::string(32, 'a'));
+  EXPECT_EQ(names[2], std::string(32, 'a'));
+}
@@ -57,3 +57,32 @@ TEST(StringToEnum, ThrowsIfInvalidSlot)
     FAIL() << "Expected std::runtime_error";
   }
 }
+
+TEST(StringToEnum, TryGetDoesNotThrow)
+{
+  EXPECT_EQ(StringToEnum::TryGet<Faction>("seeker"), Faction::kSeeker);
+  EXPECT_EQ(StringToEnum::TryGet<Faction>("seekers"), std::nullopt);
+  EXPECT_EQ(StringToEnum::TryGet<Slot>(""), std::nullopt);
+  EXPECT_EQ(StringToEnum::TryGet<EffectType>("pasive"), EffectType::kPasive);
+  EXPECT_EQ(StringToEnum::TryGet<ChaosToken::Token>("elder_sign"), ChaosToken::Token::kElderSign);
+  EXPECT_EQ(StringToEnum::TryGet<EffectModifications>("shroud"), EffectModifications::kShroud);
+  static_assert(StringToEnum::TryGet<LocationOptionalEffectCondition>("undiscovered_clues")
+                == LocationOptionalEffectCondition::kUndiscoveredClues);
+}
+
+TEST(StringToEnum, GetStringIsTheInverseOfGet)
+{
+  for (const auto token: {ChaosToken::Token::kSkull,
+                          ChaosToken::Token::kCultist,
+                          ChaosToken::Token::kTable,
+                          ChaosToken::Token::kElderThing,
+                          ChaosToken::Token::kElderSign,
+                          ChaosToken::Token::kAutoFail,
+                          ChaosToken::Token::kValue})
+  {
+    EXPECT_EQ(StringToEnum::Get<ChaosToken::Token>(StringToEnum::GetString(token)), token);
+  }
+  EXPECT_EQ(StringToEnum::GetString(Faction::kMystic), "mystic");
+  EXPECT_EQ(StringToEnum::GetString(EffectType::kDiscard), "discard");
+  EXPECT_EQ(StringToEnum::GetString(Slot::kInvalid), "invalid");
+}
@@ -0,0 +1,56 @@
+#include "card_factory.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "trigger_bus.h"
+
+using namespace ::testing;
+
+TEST(TriggerBus, FiresOnlyTheSubscribedEffects)
+{
+  const auto guardDog = CardFactory::CreateCard<Asset>("Guard Dog");
+  const auto physicalTraining = CardFactory::CreateCard<Asset>("Physical Training");
+  ASSERT_THAT(guardDog, NotNull());
+  ASSERT_THAT(physicalTraining, NotNull());
+
+  TriggerBus bus;
+  bus.Subscribe(1, *guardDog);
+  bus.Subscribe(2, *guardDog);
+  bus.Subscribe(3, *physicalTraining);
+  EXPECT_EQ(bus.GetSubscriberCount(GameEvent::kSkillTest, TriggerTarget::kNone), 2);
+  EXPECT_EQ(bus.GetSubscriberCount(GameEvent::kFight, TriggerTarget::kNone), 0);
+
+  std::vector<CardInPlayId> owners;
+  const auto fired = bus.Fire(GameEvent::kEnemyAttack,
+                              TriggerTarget::kAttackingEnemy,
+                              [&owners](const CardInPlayId owner, const EffectVariant& effect) {
+                                owners.push_back(owner);
+                                EXPECT_EQ(std::get<MakeDamageToAttacker>(effect).GetDamage(), 1);
+                              });
+  EXPECT_EQ(fired, 2);
+  EXPECT_THAT(owners, ElementsAre(1, 2));
+
+  bus.Unsubscribe(1);
+  bus.Unsubscribe(3);
+  bus.Unsubscribe(4);
+  owners.clear();
+  bus.Fire(GameEvent::kEnemyAttack, TriggerTarget::kAttackingEnemy, [&owners](const auto owner, const auto&) {
+    owners.push_back(owner);
+  });
+  EXPECT_THAT(owners, ElementsAre(2));
+  EXPECT_EQ(bus.GetSubscriberCount(GameEvent::kSkillTest, TriggerTarget::kNone), 0);
+}
+
+TEST(TriggerBus, SubscribingTwiceFiresOnce)
+{
+  const auto guardDog = CardFactory::CreateCard<Asset>("Guard Dog");
+  ASSERT_THAT(guardDog, NotNull());
+
+  TriggerBus bus;
+  bus.Subscribe(1, *guardDog);
+  bus.Subscribe(1, *guardDog);
+  EXPECT_EQ(bus.GetSubscriberCount(GameEvent::kEnemyAttack, TriggerTarget::kAttackingEnemy), 1);
+  EXPECT_EQ(bus.Fire(GameEvent::kEnemyAttack, TriggerTarget::kAttackingEnemy, [](const auto, const auto&) {}), 1);
+
+  bus.Unsubscribe(1);
+  EXPECT_EQ(bus.GetSubscriberCount(GameEvent::kEnemyAttack, TriggerTarget::kAttackingEnemy), 0);
+}